@@ -0,0 +1,155 @@
+#include "AnimationRegistry.h"
+#include "MemoryMonitor.h"
+
+static void renderRainbow(Animations& a, const MotionData& motion, unsigned long time, void* state) {
+  a.motionRainbow(motion, time);
+}
+
+static void renderSparkle(Animations& a, const MotionData& motion, unsigned long time, void* state) {
+  a.motionSparkle(motion);
+}
+
+static void renderWave(Animations& a, const MotionData& motion, unsigned long time, void* state) {
+  a.motionWave(motion, time);
+}
+
+static void renderFire(Animations& a, const MotionData& motion, unsigned long time, void* state) {
+  a.motionFire(motion, *(FireState*)state);
+}
+
+static void renderPulse(Animations& a, const MotionData& motion, unsigned long time, void* state) {
+  a.motionPulse(motion, time);
+}
+
+static void renderKaleidoscope(Animations& a, const MotionData& motion, unsigned long time, void* state) {
+  a.motionKaleidoscope(motion, time);
+}
+
+// Auto-cycle and button order
+// (Wave renders tiers only on its RGB path; the indexed one is already cheap)
+static constexpr uint8_t WAVE_FLAGS = LED_INDEXED_FRAMEBUFFER ? 0 : ANIMATION_QUALITY_TIERS;
+
+static constexpr AnimationDescriptor modes[] PROGMEM = {
+  { "Rainbow",      0,                 0,                       nullptr, renderRainbow,      nullptr },
+  { "Sparkle",      0,                 0,                       nullptr, renderSparkle,      nullptr },
+  { "Wave",         0,                 WAVE_FLAGS,              nullptr, renderWave,         nullptr },
+  { "Fire",         sizeof(FireState), 0,                       nullptr, renderFire,         nullptr },
+  { "Pulse",        0,                 0,                       nullptr, renderPulse,        nullptr },
+  { "Kaleidoscope", 0,                 ANIMATION_QUALITY_TIERS, nullptr, renderKaleidoscope, nullptr },
+};
+
+static constexpr uint8_t MODE_COUNT = sizeof(modes) / sizeof(modes[0]);
+
+static_assert(MODE_COUNT <= PROFILER_MAX_MODES, "PROFILER_MAX_MODES must cover every registered mode");
+
+// Arena size: the largest sum of two states, evaluated at compile time
+static constexpr uint16_t largerOf(uint16_t a, uint16_t b) {
+  return a > b ? a : b;
+}
+
+static constexpr uint16_t largestStateFrom(uint8_t i) {
+  return i >= MODE_COUNT ? 0 : largerOf(modes[i].stateSize, largestStateFrom(i + 1));
+}
+
+static constexpr uint16_t largestPairFrom(uint8_t i) {
+  return i >= MODE_COUNT ? 0
+         : largerOf(modes[i].stateSize + largestStateFrom(i + 1), largestPairFrom(i + 1));
+}
+
+static constexpr uint16_t ARENA_SIZE = largestPairFrom(0);
+
+static_assert(ARENA_SIZE + sizeof(AnimationRegistry) <= MEMORY_BUDGET_ARENA * MEMORY_BUDGET_SCALE,
+              "Mode state arena is over MEMORY_BUDGET_ARENA");
+
+// Word-aligned so state structs with wider members sit correctly on the host
+static union {
+  uint8_t bytes[ARENA_SIZE > 0 ? ARENA_SIZE : 1];
+  uint32_t align;
+} arena;
+
+AnimationRegistry::AnimationRegistry(Animations& animations)
+  : animations(animations), currentSlot(0) {
+  slotMode[0] = MODE_COUNT;
+  slotMode[1] = MODE_COUNT;
+}
+
+uint8_t AnimationRegistry::count() {
+  return MODE_COUNT;
+}
+
+void AnimationRegistry::descriptor(uint8_t mode, AnimationDescriptor& out) {
+  memcpy_P(&out, &modes[mode < MODE_COUNT ? mode : 0], sizeof(out));
+}
+
+const char* AnimationRegistry::name(uint8_t mode) {
+  if (mode >= MODE_COUNT) return "Unknown";
+
+  AnimationDescriptor d;
+  descriptor(mode, d);
+  return d.name;
+}
+
+uint8_t AnimationRegistry::find(const char* name) {
+  for (uint8_t mode = 0; mode < MODE_COUNT; mode++) {
+    if (strcmp(AnimationRegistry::name(mode), name) == 0) return mode;
+  }
+  return MODE_COUNT;
+}
+
+uint16_t AnimationRegistry::arenaSize() {
+  return ARENA_SIZE;
+}
+
+bool AnimationRegistry::hasQualityTiers(uint8_t mode) {
+  if (mode >= MODE_COUNT) return false;
+
+  AnimationDescriptor d;
+  descriptor(mode, d);
+  return d.flags & ANIMATION_QUALITY_TIERS;
+}
+
+// Low slot grows up from the start, high slot down from the end
+void* AnimationRegistry::slotState(uint8_t slot, uint16_t size) {
+  return slot == 0 ? arena.bytes : arena.bytes + ARENA_SIZE - size;
+}
+
+void AnimationRegistry::activate(uint8_t mode) {
+  if (mode >= MODE_COUNT) return;
+
+  // Already live: just make it current (state carries on)
+  if (slotMode[currentSlot] == mode) return;
+  uint8_t freeSlot = currentSlot ^ 1;
+  if (slotMode[freeSlot] == mode) {
+    currentSlot = freeSlot;
+    return;
+  }
+
+  AnimationDescriptor d;
+  if (slotMode[freeSlot] < MODE_COUNT) {
+    descriptor(slotMode[freeSlot], d);
+    if (d.teardown) d.teardown(animations, slotState(freeSlot, d.stateSize));
+  }
+
+  descriptor(mode, d);
+  void* state = slotState(freeSlot, d.stateSize);
+  memset(state, 0, d.stateSize);
+  if (d.init) d.init(animations, state);
+
+  slotMode[freeSlot] = mode;
+  currentSlot = freeSlot;
+}
+
+void AnimationRegistry::render(uint8_t mode, const MotionData& motion, unsigned long time) {
+  uint8_t slot;
+  if (slotMode[currentSlot] == mode) {
+    slot = currentSlot;
+  } else if (slotMode[currentSlot ^ 1] == mode) {
+    slot = currentSlot ^ 1;
+  } else {
+    return;
+  }
+
+  AnimationDescriptor d;
+  descriptor(mode, d);
+  d.render(animations, motion, time, slotState(slot, d.stateSize));
+}
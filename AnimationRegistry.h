@@ -0,0 +1,55 @@
+#ifndef ANIMATION_REGISTRY_H
+#define ANIMATION_REGISTRY_H
+
+#include <Arduino.h>
+#include "Animations.h"
+#include "MotionProcessor.h"
+
+// Descriptor flags
+#define ANIMATION_QUALITY_TIERS 0x01  // render() honours Animations::quality()
+
+// One entry per display mode. state points at stateSize bytes of the
+// shared scratch arena, zeroed before init() runs; init and teardown may
+// be null.
+struct AnimationDescriptor {
+  const char* name;
+  uint16_t stateSize;
+  uint8_t flags;
+  void (*init)(Animations& animations, void* state);
+  void (*render)(Animations& animations, const MotionData& motion, unsigned long time, void* state);
+  void (*teardown)(Animations& animations, void* state);
+};
+
+// The mode table (PROGMEM) and the scratch arena its state lives in.
+//
+// At most two modes are live: the current one and the one it replaced,
+// which keeps rendering underneath a transition. They take opposite ends
+// of the arena, so it only has to hold the two largest states rather than
+// all of them; adding a mode without state costs flash, not SRAM.
+class AnimationRegistry {
+public:
+  AnimationRegistry(Animations& animations);
+
+  static uint8_t count();
+  static const char* name(uint8_t mode);
+  static uint8_t find(const char* name);  // count() if there is no such mode
+  static uint16_t arenaSize();
+  static bool hasQualityTiers(uint8_t mode);  // The governor only steps tiers for these
+
+  // Make mode current. The previous current mode stays live; whichever
+  // mode was live before it is torn down and its end of the arena reused.
+  void activate(uint8_t mode);
+
+  // Render a live mode (current or outgoing); others are ignored
+  void render(uint8_t mode, const MotionData& motion, unsigned long time);
+
+private:
+  Animations& animations;
+  uint8_t slotMode[2];  // Mode at the low / high end of the arena, count() if free
+  uint8_t currentSlot;
+
+  static void descriptor(uint8_t mode, AnimationDescriptor& out);
+  void* slotState(uint8_t slot, uint16_t size);
+};
+
+#endif
@@ -1,17 +1,53 @@
 #include "Animations.h"
+#include "FixedMath.h"
+#include "FastRandom.h"
+
+// Gradient band edges (0.33 and 0.66 of a turn)
+#define GRADIENT_BAND1 21627
+#define GRADIENT_BAND2 43254
+
+// Soft edge of the wipe transition, in pixels
+#define WIPE_EDGE_PIXELS 8
+
+// Rotation hue shift of the fire palette is quantized to this many hue
+// steps (5.6 degrees) so a spinning tube doesn't rebuild it every frame
+#define FIRE_HUE_SHIFT_STEP 4
+
+// Brightness flash after a tap on the tube (Pulse mode)
+#define PULSE_TAP_FLASH_MS 300
+
+// Share of the motion energy in one spectrum bin that locks Pulse to it
+#define PULSE_RHYTHM_LOCK 0.5
+
+// Kaleidoscope wave drift: time/200 and time/300 radians, in turns/s (Q16.16)
+#define KALEIDO_WAVE1_RATE_Q16 52152UL
+#define KALEIDO_WAVE2_RATE_Q16 34768UL
 
 Animations::Animations(LEDController& ledController)
-  : leds(ledController) {
-  // Initialize heat array for fire effect
-  memset(heat, 0, sizeof(heat));
+  : leds(ledController), qualityTier(QUALITY_FULL) {
+  layer.reset();
 }
 
 // Rainbow effect across all LEDs
 void Animations::rainbow(uint8_t offset, float speed) {
+#if LED_INDEXED_FRAMEBUFFER
+  // Hue wheel palette; the index is the hue
+  CRGB* palette = leds.palette();
+  for (uint8_t k = 0; k < 16; k++) {
+    palette[k] = CHSV(k * 16, 255, 255);
+  }
+  leds.setPaletteWraps(true);
+
+  uint8_t* indices = leds.indexBuffer();
+  for (uint16_t i = 0; i < leds.numLeds(); i++) {
+    indices[i] = (i * 256 / leds.numLeds() + offset) % 256;
+  }
+#else
   for (uint16_t i = 0; i < leds.numLeds(); i++) {
     uint8_t hue = (i * 256 / leds.numLeds() + offset) % 256;
     leds.setPixel(i, CHSV(hue, 255, 255));
   }
+#endif
 }
 
 // Rainbow effect with each segment having a different color
@@ -30,7 +66,7 @@ void Animations::sparkle(CRGB baseColor, CRGB sparkleColor, float density) {
   // Add random sparkles
   uint16_t numSparkles = leds.numLeds() * density;
   for (uint16_t i = 0; i < numSparkles; i++) {
-    uint16_t pos = random(leds.numLeds());
+    uint16_t pos = rng16(leds.numLeds());
     leds.setPixel(pos, sparkleColor);
   }
 }
@@ -41,8 +77,8 @@ void Animations::twinkle(CRGB color, float speed, float density) {
   fadeToBlackBy(20 * speed);
 
   // Add new twinkles
-  if (random(100) < density * 100) {
-    uint16_t pos = random(leds.numLeds());
+  if (rng8() < density * 256) {
+    uint16_t pos = rng16(leds.numLeds());
     leds.setPixel(pos, color);
   }
 }
@@ -59,39 +95,74 @@ void Animations::chase(CRGB color, uint8_t chaseSize, uint16_t position) {
 
 // Wave effect
 void Animations::wave(uint8_t hue, uint8_t waveWidth, float position) {
+  if (waveWidth == 0) waveWidth = 1;
+
+  // One full turn every waveWidth pixels, accumulated in Q16.16
+  uint32_t step = 0xFFFFFFFFUL / waveWidth;
+  uint32_t phase = (uint32_t)phaseFromTurns(position * 10 / waveWidth) << 16;
+
+#if LED_INDEXED_FRAMEBUFFER
+  // Black-to-hue ramp; the index is the brightness
+  setRampPalette(hue);
+
+  uint8_t* indices = leds.indexBuffer();
   for (uint16_t i = 0; i < leds.numLeds(); i++) {
-    float wave = sin((i + position * 10) * 2 * PI / waveWidth);
-    uint8_t brightness = (wave + 1.0) * 127.5; // Map -1..1 to 0..255
-    leds.setPixel(i, CHSV(hue, 255, brightness));
+    indices[i] = isin8u(phase >> 16);
+    phase += step;
+  }
+#else
+  // Every sampleStep()-th pixel (and the last) pays for the HSV conversion
+  SegmentSpan strip(leds.pixels(), 1, leds.numLeds());
+  uint8_t sample = sampleStep();
+  uint16_t last = strip.size() - 1;
+  uint32_t firstPhase = phase;
+  for (uint16_t i = 0; i < strip.size(); i += sample) {
+    strip[i] = CHSV(hue, 255, isin8u(phase >> 16));
+    phase += step * sample;
+  }
+  if (last % sample) {
+    strip[last] = CHSV(hue, 255, isin8u((firstPhase + step * last) >> 16));
   }
+  if (sample > 1) upsample(strip, sample);
+#endif
 }
 
 // Three-color gradient that can be animated
 void Animations::gradient(CRGB color1, CRGB color2, CRGB color3, float position) {
   uint16_t numLeds = leds.numLeds();
 
+  // t runs 0..65535 once along the strip, wrapping like the fmod() it replaces
+  uint32_t step = 0xFFFFFFFFUL / numLeds;
+  uint32_t t = (uint32_t)phaseFromTurns(position) << 16;
+
   for (uint16_t i = 0; i < numLeds; i++) {
-    float adjustedPos = fmod(i + position * numLeds, numLeds);
-    float t = adjustedPos / numLeds;
+    uint16_t t16 = t >> 16;
 
     CRGB color;
-    if (t < 0.33) {
-      color = lerpColor(color1, color2, t * 3.0);
-    } else if (t < 0.66) {
-      color = lerpColor(color2, color3, (t - 0.33) * 3.0);
+    if (t16 < GRADIENT_BAND1) {
+      color = lerpColor(color1, color2, bandFraction(t16));
+    } else if (t16 < GRADIENT_BAND2) {
+      color = lerpColor(color2, color3, bandFraction(t16 - GRADIENT_BAND1));
     } else {
-      color = lerpColor(color3, color1, (t - 0.66) * 3.0);
+      color = lerpColor(color3, color1, bandFraction(t16 - GRADIENT_BAND2));
     }
 
     leds.setPixel(i, color);
+    t += step;
   }
 }
 
 // Fire effect
-void Animations::fire(uint8_t cooling, uint8_t sparking) {
-  // Cool down every cell a little
+void Animations::fire(FireState& state, uint8_t cooling, uint8_t sparking, uint8_t hueShift) {
+  uint8_t* heat = state.heat;
+
+  // Cool down every cell a little, drawing the random bytes in batches
+  uint8_t coolingRange = ((cooling * 10) / leds.numLeds()) + 2;
+  uint8_t noise[32];
   for (uint16_t i = 0; i < leds.numLeds(); i++) {
-    uint8_t cooldown = random(0, ((cooling * 10) / leds.numLeds()) + 2);
+    uint8_t batchIndex = i % sizeof(noise);
+    if (batchIndex == 0) rngFill(noise, sizeof(noise));
+    uint8_t cooldown = rngScale8(noise[batchIndex], coolingRange);
 
     if (cooldown > heat[i]) {
       heat[i] = 0;
@@ -106,20 +177,39 @@ void Animations::fire(uint8_t cooling, uint8_t sparking) {
   }
 
   // Randomly ignite new sparks near the bottom
-  if (random(255) < sparking) {
-    uint8_t y = random(7);
-    heat[y] = heat[y] + random(160, 255);
+  if (rng8() < sparking) {
+    uint8_t y = rng8(7);
+    heat[y] = heat[y] + rng8(160, 255);
+  }
+
+  // Map heat through the (hue-shifted) heat palette
+  if (!state.paletteReady || hueShift != state.paletteShift) {
+    buildHeatPalette(state.palette, hueShift);
+    state.paletteShift = hueShift;
+    state.paletteReady = true;
   }
 
-  // Convert heat to LED colors
+#if LED_INDEXED_FRAMEBUFFER
+  memcpy(leds.palette(), state.palette, sizeof(state.palette));
+  leds.setPaletteWraps(false);
+
+  memcpy(leds.indexBuffer(), heat, leds.numLeds());
+#else
   for (uint16_t j = 0; j < leds.numLeds(); j++) {
-    leds.setPixel(j, LEDController::heatColor(heat[j]));
+    // Same lookup as an indexed ramp: entry k sits at heat k * 17
+    uint8_t index = scale8(heat[j], 240);
+    uint8_t entry = index >> 4;
+    uint8_t frac = (index & 0x0F) << 4;
+    const CRGB& a = state.palette[entry];
+    const CRGB& b = state.palette[entry < 15 ? entry + 1 : 15];
+    leds.setPixel(j, lerpColor(a, b, frac));
   }
+#endif
 }
 
 // Pulse effect
 void Animations::pulse(CRGB color, float phase) {
-  uint8_t brightness = (sin(phase * 2 * PI) + 1.0) * 127.5;
+  uint8_t brightness = isin8u(phaseFromTurns(phase));
 
   CHSV hsvColor = rgb2hsv_approximate(color);
   hsvColor.v = brightness;
@@ -198,23 +288,18 @@ void Animations::motionWave(const MotionData& motion, unsigned long time) {
 }
 
 // Fire effect that reacts to shake (intensity) and tilt (color)
-void Animations::motionFire(const MotionData& motion) {
+void Animations::motionFire(const MotionData& motion, FireState& state) {
   // Shake increases sparking, tilt affects cooling
   uint8_t cooling = 55 + motion.tiltNormalized * 30;
   uint8_t sparking = 100 + motion.shakeNormalized * 100;
 
-  fire(cooling, sparking);
-
-  // Shift hue based on rotation
+  // Rotation shifts the hue of the whole heat palette
+  uint8_t hueShift = 0;
   if (motion.rotationNormalized > 0.1) {
-    uint8_t hueShift = motion.rotationSpeed / 2;
-    for (uint16_t i = 0; i < leds.numLeds(); i++) {
-      CRGB color = leds.getPixel(i);
-      CHSV hsv = rgb2hsv_approximate(color);
-      hsv.h += hueShift;
-      leds.setPixel(i, hsv);
-    }
+    hueShift = (uint8_t)(motion.rotationSpeed / 2) & ~(FIRE_HUE_SHIFT_STEP - 1);
   }
+
+  fire(state, cooling, sparking, hueShift);
 }
 
 // Pulse that reacts to all motion types
@@ -224,10 +309,23 @@ void Animations::motionPulse(const MotionData& motion, unsigned long time) {
   uint8_t hue = motion.tiltAngle * 2;
   uint8_t baseBrightness = 100 + motion.shakeNormalized * 155;
 
-  float phase = (time / 1000.0) * speed;
-  uint8_t brightness = (sin(phase * 2 * PI) + 1.0) * 127.5;
+  // A steady sway or shake rhythm sets the pulse rate instead: one pulse
+  // per swing
+  if (motion.motionRhythm >= PULSE_RHYTHM_LOCK) {
+    speed = motion.motionFrequency;
+  }
+
+  uint8_t brightness = isin8u(phaseFromMillis(time, speed * 65536));
   brightness = map(brightness, 0, 255, baseBrightness / 2, baseBrightness);
 
+  // A tap flashes to full brightness and fades back over PULSE_TAP_FLASH_MS
+  unsigned long sinceGesture = time - motion.gestureMillis;
+  if ((motion.lastGesture == GESTURE_TAP || motion.lastGesture == GESTURE_DOUBLE_TAP) &&
+      sinceGesture < PULSE_TAP_FLASH_MS) {
+    uint8_t flash = 255 - sinceGesture * 255 / PULSE_TAP_FLASH_MS;
+    brightness = qadd8(brightness, flash);
+  }
+
   leds.fill(CHSV(hue, 255, brightness));
 }
 
@@ -237,35 +335,216 @@ void Animations::motionKaleidoscope(const MotionData& motion, unsigned long time
   float speed = 1.5 + motion.rotationNormalized * 4.0;  // More responsive
   uint8_t hueBase = (uint32_t)(time / (20 / speed)) % 256;  // Faster color cycling
 
-  // Add tilt-based hue shift
+  // Add tilt-based hue shift; panning turns the palette with the tube
   hueBase += motion.tiltAngle;
+  hueBase += (int16_t)(motion.yaw * (256.0 / 360.0));
+
+  // Shake scales brightness from 50% to 100%
+  uint8_t shakeScale = 127 + motion.shakeNormalized * 128;
 
+  // Time drift of the two waves
+  phase16_t drift1 = phaseFromMillis(time, KALEIDO_WAVE1_RATE_Q16);
+  phase16_t drift2 = phaseFromMillis(time, KALEIDO_WAVE2_RATE_Q16);
+
+  uint32_t drawn = 0;  // Bit per segment already rendered
   for (uint8_t seg = 0; seg < leds.numSegments(); seg++) {
-    Segment segment = leds.getSegment(seg);
-    uint8_t hueOffset = seg * 85; // 120 degree hue offset for each segment
+    if (drawn & (1UL << seg)) continue;
+
+    // The folds differ only by 85 steps of hue: with KALEIDOSCOPE_SYMMETRIC
+    // every later fold as long as this one shares its wave math and gets
+    // just its own HSV conversion. A fold of another length (the 69 of
+    // 70/70/69) has different waves and is rendered on its own.
+    SegmentSpan spans[NUM_SEGMENTS];
+    uint8_t hueOffsets[NUM_SEGMENTS];
+    spans[0] = leds.segmentSpan(seg);
+    hueOffsets[0] = 0;
+    uint8_t folds = 1;
+#if KALEIDOSCOPE_SYMMETRIC
+    for (uint8_t other = seg + 1; other < leds.numSegments(); other++) {
+      if (leds.getSegment(other).length != spans[0].size()) continue;
+      spans[folds] = leds.segmentSpan(other);
+      hueOffsets[folds++] = (other - seg) * 85;
+      drawn |= 1UL << other;
+    }
+#endif
+
+    // Per-pixel steps: wave1 makes two turns and wave2 one turn along the
+    // segment (Q16.16), hue sweeps 60 steps (Q8.8)
+    uint16_t size = spans[0].size();
+    uint32_t turnStep = 0xFFFFFFFFUL / size;
+    uint32_t phase1 = (uint32_t)drift1 << 16;
+    uint32_t phase2 = (uint32_t)(phase16_t)(0 - drift2) << 16;
+    uint16_t hueStep = (60 * FIXED_ONE_Q8_8) / size;
+    uint16_t hueAccum = (uint16_t)(uint8_t)(hueBase + seg * 85) << 8;  // 120 degrees per segment
+
+    // Reduced quality: every step-th pixel and the segment's last one,
+    // blended in between by upsample()
+    uint8_t step = sampleStep();
+    uint32_t phase1Step = turnStep * 2 * step;
+    uint32_t phase2Step = turnStep * step;
+    uint16_t hueSampleStep = hueStep * step;
+    uint16_t last = size - 1;
+    uint16_t p = 0;
+    while (true) {
+      uint8_t brightness = kaleidoscopeBrightness(phase1, phase2, shakeScale);
+      uint8_t hue = hueAccum >> 8;
+      for (uint8_t f = 0; f < folds; f++) {
+        spans[f][p] = CHSV(hue + hueOffsets[f], 255, brightness);
+      }
+      if (p == last) break;
+
+      if (last - p < step) {
+        uint16_t rest = last - p;
+        phase1 += turnStep * 2 * rest;
+        phase2 += turnStep * rest;
+        hueAccum += hueStep * rest;
+        p = last;
+      } else {
+        phase1 += phase1Step;
+        phase2 += phase2Step;
+        hueAccum += hueSampleStep;
+        p += step;
+      }
+    }
+    if (step > 1) {
+      for (uint8_t f = 0; f < folds; f++) upsample(spans[f], step);
+    }
+  }
+}
 
-    for (uint16_t pos = 0; pos < segment.length; pos++) {
-      // Create symmetrical pattern
-      float normalizedPos = (float)pos / segment.length;
+// Brightness is the average of both waves, scaled by shake
+uint8_t Animations::kaleidoscopeBrightness(uint32_t phase1, uint32_t phase2, uint8_t shakeScale) {
+  int32_t waves = (int32_t)isin16(phase1 >> 16) + isin16(phase2 >> 16);
+  uint8_t brightness = (waves / 2 + 32768) >> 8;
+  return scale8(brightness, shakeScale);
+}
 
-      // Wave pattern based on position
-      float wave1 = sin(normalizedPos * 4 * PI + time / 200.0);
-      float wave2 = sin(normalizedPos * 2 * PI - time / 300.0);
+// === TRANSITIONS ===
 
-      // Brightness based on waves and shake
-      uint8_t brightness = ((wave1 + wave2) / 2.0 + 1.0) * 127.5;
-      brightness = brightness * (0.5 + motion.shakeNormalized * 0.5);
+void Animations::startTransition() {
+  layer = leds.frameBuffer();
+}
 
-      // Hue based on position, segment, and motion
-      uint8_t hue = hueBase + hueOffset + (normalizedPos * 60);
+void Animations::beginLayer() {
+  leds.renderInto(&layer);
+}
+
+void Animations::endLayer() {
+  leds.renderInto(nullptr);
+}
 
-      leds.setSegmentPixel(seg, pos, CHSV(hue, 255, brightness));
+// One source of a blend: its pixels, or its indices when it is still an
+// indexed frame. Reading through this rather than FrameBuffer::color()
+// keeps the indexed checks out of the loops' stores.
+struct BlendSource {
+  const FrameBuffer& frame;
+  const uint8_t* indices;  // Null unless indexed
+
+  explicit BlendSource(const FrameBuffer& f)
+    : frame(f),
+#if LED_INDEXED_FRAMEBUFFER
+      indices(f.indexed ? f.indices() : nullptr) {}
+#else
+      indices(nullptr) {}
+#endif
+
+  CRGB operator[](uint16_t i) const {
+#if LED_INDEXED_FRAMEBUFFER
+    if (indices) return frame.paletteColor(indices[i]);
+#endif
+    return frame.pixels[i];
+  }
+};
+
+// Ascending pixel order throughout, so reading an indexed frame's colour
+// before writing its pixel is safe (FrameBuffer::color())
+void Animations::composite(TransitionStyle style, uint8_t progress) {
+  FrameBuffer& frame = leds.frameBuffer();
+  const BlendSource in(frame);
+  const BlendSource out(layer);
+  CRGB* pixels = frame.pixels;
+
+  switch (style) {
+    case TRANSITION_ADDITIVE: {
+      // First half adds the incoming frame at rising strength, second half
+      // fades the outgoing one off the top of it
+      uint8_t incoming = progress < 128 ? progress * 2 : 255;
+      uint8_t outgoing = progress < 128 ? 255 : (255 - progress) * 2;
+      for (uint16_t i = 0; i < NUM_LEDS; i++) {
+        CRGB a = out[i];
+        CRGB b = in[i];
+        pixels[i] = CRGB(qadd8(scale8(a.r, outgoing), scale8(b.r, incoming)),
+                         qadd8(scale8(a.g, outgoing), scale8(b.g, incoming)),
+                         qadd8(scale8(a.b, outgoing), scale8(b.b, incoming)));
+      }
+      break;
     }
+
+    case TRANSITION_WIPE: {
+      for (uint8_t seg = 0; seg < leds.numSegments(); seg++) {
+        Segment segment = leds.getSegment(seg);
+
+        // Edge front in Q8.8 pixels, from before the first pixel to past
+        // the last; positions run along the segment, whichever way it is wired
+        int32_t front = ((int32_t)progress * (segment.length + WIPE_EDGE_PIXELS) * FIXED_ONE_Q8_8) / 255;
+        int32_t position = segment.reversed ? (int32_t)(segment.length - 1) * FIXED_ONE_Q8_8 : 0;
+        int32_t positionStep = segment.reversed ? -FIXED_ONE_Q8_8 : FIXED_ONE_Q8_8;
+
+        for (uint16_t i = segment.start; i <= segment.end; i++) {
+          int32_t alpha = (front - position) / WIPE_EDGE_PIXELS;
+          if (alpha <= 0) {
+            pixels[i] = out[i];
+          } else if (alpha < 255) {
+            CRGB b = in[i];
+            pixels[i] = lerpColor(out[i], b, alpha);
+          } else if (in.indices) {
+            pixels[i] = in[i];
+          }
+          position += positionStep;
+        }
+      }
+      break;
+    }
+
+    case TRANSITION_CROSSFADE:
+    default:
+      for (uint16_t i = 0; i < NUM_LEDS; i++) {
+        CRGB b = in[i];
+        pixels[i] = lerpColor(out[i], b, progress);
+      }
+      break;
   }
+
+#if LED_INDEXED_FRAMEBUFFER
+  frame.indexed = false;
+#endif
 }
 
 // === UTILITY FUNCTIONS ===
 
+#if LED_INDEXED_FRAMEBUFFER
+// Palette ramping from black to full brightness at one hue
+void Animations::setRampPalette(uint8_t hue) {
+  CRGB* palette = leds.palette();
+  for (uint8_t k = 0; k < 16; k++) {
+    palette[k] = CHSV(hue, 255, k * 17);
+  }
+  leds.setPaletteWraps(false);
+}
+#endif
+
+// Heat palette (entry k = heatColor(k * 17)), hue-rotated by hueShift
+void Animations::buildHeatPalette(CRGB* palette, uint8_t hueShift) {
+  for (uint8_t k = 0; k < 16; k++) {
+    palette[k] = LEDController::heatColor(k * 17);
+    if (hueShift) {
+      CHSV hsv = rgb2hsv_approximate(palette[k]);
+      hsv.h += hueShift;
+      palette[k] = hsv;
+    }
+  }
+}
+
 void Animations::fadeToBlackBy(uint8_t fadeAmount) {
   for (uint16_t i = 0; i < leds.numLeds(); i++) {
     leds.setPixel(i, leds.getPixel(i).fadeToBlackBy(fadeAmount));
@@ -305,15 +584,33 @@ void Animations::blur(uint8_t blurAmount) {
   ).nscale8(255 - blurAmount / 2));
 }
 
-CRGB Animations::lerpColor(CRGB a, CRGB b, float t) {
-  t = constrain(t, 0.0, 1.0);
+CRGB Animations::lerpColor(CRGB a, CRGB b, uint8_t frac) {
   return CRGB(
-    a.r + (b.r - a.r) * t,
-    a.g + (b.g - a.g) * t,
-    a.b + (b.b - a.b) * t
+    lerp8(a.r, b.r, frac),
+    lerp8(a.g, b.g, frac),
+    lerp8(a.b, b.b, frac)
   );
 }
 
+// Fill the pixels between rendered samples (every step-th pixel plus the
+// last one) with a linear blend of the samples on either side
+void Animations::upsample(const SegmentSpan& span, uint8_t step) {
+  uint16_t last = span.size() - 1;
+  for (uint16_t from = 0; from < last; from += step) {
+    uint16_t to = from + step < last ? from + step : last;
+    uint16_t gap = to - from;
+    for (uint16_t p = 1; p < gap; p++) {
+      span[from + p] = lerpColor(span[from], span[to], p * 256 / gap);
+    }
+  }
+}
+
+// Position within a gradient band (one third of a turn) as 0..255
+uint8_t Animations::bandFraction(uint16_t offset) {
+  uint32_t frac = ((uint32_t)offset * 3) >> 8;
+  return frac > 255 ? 255 : frac;
+}
+
 uint8_t Animations::beatSin8(uint16_t bpm, uint8_t lowest, uint8_t highest, unsigned long timebase, uint16_t phaseOffset) {
   uint16_t beat = (timebase * bpm) / 60;
   uint8_t sinValue = sin8(beat + phaseOffset);
@@ -14,6 +14,33 @@ struct AnimationParams {
   bool reverse;       // Reverse direction
 };
 
+// Fire mode state: heat cells plus the heat palette at the current hue
+// shift (16 entries at k * 17), rebuilt only when the shift changes
+struct FireState {
+  uint8_t heat[NUM_LEDS];
+  CRGB palette[16];
+  uint8_t paletteShift;
+  bool paletteReady;
+};
+
+// Mode transition styles (see composite())
+enum TransitionStyle {
+  TRANSITION_CROSSFADE,  // Linear 8-bit alpha blend
+  TRANSITION_ADDITIVE,   // Incoming rises over the old frame, then the old frame fades out
+  TRANSITION_WIPE        // Soft edge sweeping along every segment from its start
+};
+
+// Render quality tiers, set by QualityGovernor when frames run over
+// budget. Modes whose cost is per-pixel math render every 1st, 2nd or 4th
+// pixel along each segment and blend the pixels in between; modes that
+// are already cheap ignore the tier.
+enum QualityTier {
+  QUALITY_FULL,
+  QUALITY_HALF,
+  QUALITY_QUARTER
+};
+#define QUALITY_TIERS 3
+
 class Animations {
 public:
   Animations(LEDController& ledController);
@@ -26,7 +53,7 @@ public:
   void chase(CRGB color, uint8_t chaseSize, uint16_t position);
   void wave(uint8_t hue, uint8_t waveWidth, float position);
   void gradient(CRGB color1, CRGB color2, CRGB color3, float position = 0);
-  void fire(uint8_t cooling = 55, uint8_t sparking = 120);
+  void fire(FireState& state, uint8_t cooling = 55, uint8_t sparking = 120, uint8_t hueShift = 0);
   void pulse(CRGB color, float phase);
   void strobe(CRGB color, uint8_t onFrames, uint8_t offFrames, uint16_t counter);
   void meteor(CRGB color, uint8_t meteorSize, uint8_t trailDecay, uint16_t position);
@@ -36,10 +63,29 @@ public:
   void motionRainbow(const MotionData& motion, unsigned long time);
   void motionSparkle(const MotionData& motion);
   void motionWave(const MotionData& motion, unsigned long time);
-  void motionFire(const MotionData& motion);
+  void motionFire(const MotionData& motion, FireState& state);
   void motionPulse(const MotionData& motion, unsigned long time);
   void motionKaleidoscope(const MotionData& motion, unsigned long time);
 
+  // Mode transitions: startTransition() seeds the outgoing layer with the
+  // frame on the strip. Each transition frame the outgoing mode renders
+  // straight into the layer between beginLayer() and endLayer(), the
+  // incoming one into the frame that is shown, and composite() blends the
+  // layer into that frame. progress runs 0 (all outgoing) to 255 (all
+  // incoming). The blend is the only extra pass: no copy-out, and an
+  // indexed frame on either side is expanded as the blend reads it rather
+  // than in a pass of its own (at show() for a normal frame). Fire ->
+  // Kaleidoscope on the host, render plus show() in median cycles:
+  // Kaleidoscope alone 16.5k; crossfade 32k, additive 30k, wipe 23k.
+  void startTransition();
+  void beginLayer();
+  void endLayer();
+  void composite(TransitionStyle style, uint8_t progress);
+
+  // Quality tier for the following frames
+  void setQuality(QualityTier tier) { qualityTier = tier; }
+  QualityTier quality() const { return qualityTier; }
+
   // Utility functions
   void fadeToBlackBy(uint8_t fadeAmount);
   void blur(uint8_t blurAmount);
@@ -47,11 +93,23 @@ public:
 private:
   LEDController& leds;
 
-  // Fire effect heat array
-  byte heat[NUM_LEDS];
+  // Outgoing mode's frame during a transition
+  FrameBuffer layer;
+
+  QualityTier qualityTier;
+
+  // Distance between rendered pixels at the current tier
+  uint8_t sampleStep() const { return 1 << qualityTier; }
+  void upsample(const SegmentSpan& span, uint8_t step);
 
   // Helper functions
-  CRGB lerpColor(CRGB a, CRGB b, float t);
+  CRGB lerpColor(CRGB a, CRGB b, uint8_t frac);
+  static uint8_t bandFraction(uint16_t offset);
+  static uint8_t kaleidoscopeBrightness(uint32_t phase1, uint32_t phase2, uint8_t shakeScale);
+  static void buildHeatPalette(CRGB* palette, uint8_t hueShift);
+#if LED_INDEXED_FRAMEBUFFER
+  void setRampPalette(uint8_t hue);
+#endif
   uint8_t beatSin8(uint16_t bpm, uint8_t lowest, uint8_t highest, unsigned long timebase, uint16_t phaseOffset);
 };
 
@@ -4,16 +4,51 @@
 // LED Configuration
 #define LED_PIN 4              // Data pin for WS2818
 #define NUM_LEDS 209           // Total LEDs on strip
-#define LEDS_PER_SEGMENT 70    // LEDs per segment (209/3 = ~70, last segment has 69)
-#define NUM_SEGMENTS 3         // Number of segments
+#define NUM_SEGMENTS 3         // Number of segments (lengths derived in SegmentLayout.h: 70 + 70 + 69)
+#define SEGMENT_REVERSE_MASK 0xAAAAAAAAUL  // Bit n set = segment n runs backwards (odd folds)
+// #define SEGMENT_LENGTHS { 70, 70, 69 }  // Optional explicit lengths, must sum to NUM_LEDS
+
+// LED Output
+#ifndef LED_PARALLEL_OUTPUT
+#define LED_PARALLEL_OUTPUT 0  // 1 = one data line per segment (segment n on PORTA bit n = pin 22 + n), see ParallelLEDOutput.h
+#endif
+#define LED_PARALLEL_PORT PORTA
+#define LED_PARALLEL_DDR DDRA
+#define WS2812_LATCH_US 300    // Low time that latches a frame (WS2812B-V5 needs 280 us)
+#define LED_INDEXED_FRAMEBUFFER 1  // 1 = Fire/Wave/Rainbow render 1-byte palette indices (inside leds[]), expanded at show(); saves per-pixel colour math, not SRAM
+#define LED_SKIP_UNCHANGED_FRAMES 1  // 1 = show() doesn't retransmit a frame identical to the last one sent
+#define LED_REFRESH_MS 1000    // Resend an unchanged frame at least this often (recovers from glitches)
 
 // LED Brightness (0-255)
-#define MAX_BRIGHTNESS 50     // Maximum brightness to avoid power issues
+#define MAX_BRIGHTNESS 255    // Power is capped per frame by the limiter below, not by brightness
 #define DEFAULT_BRIGHTNESS 20
 
+// Power Limiting (per-frame current estimate in LEDController::show())
+#define ENABLE_POWER_LIMIT 1
+#define POWER_BUDGET_MA 2500   // Supply current for the strip (full white at the old 50/255 cap)
+#define LED_MA_PER_CHANNEL 20  // WS2812B draw per colour channel at full duty
+#define LED_IDLE_MA 1          // WS2812B draw per LED when dark
+
 // Motion Sensor Configuration
 #define MPU_UPDATE_RATE 100    // Hz - how often to read sensor (increased for smoother response)
 #define MOTION_SMOOTHING 0.15  // 0-1, lower = more smoothing (slightly faster response)
+#define FUSION_TIME_CONSTANT_MS 500  // Gyro/accel crossover for pitch and roll (higher = steadier, slower drift correction)
+#define FUSION_ACCEL_TOLERANCE 0.2   // Skip accel correction when |a| is off 1 G by more than this fraction
+#define MOTION_HISTORY_SIZE 4             // Timestamped samples kept for frame-time interpolation (power of two)
+#define MOTION_SENSOR_DELAY_US 4900       // DLPF group delay (44 Hz); sample timestamps are shifted back by this
+#define MOTION_MAX_EXTRAPOLATION_US 30000 // Cap on how far past the newest sample motion is predicted
+#define ENABLE_GESTURES 1                 // Tap, flick, tilt-hold and shake events (thresholds in GestureDetector.h)
+#ifndef ENABLE_MOTION_SPECTRUM
+#define ENABLE_MOTION_SPECTRUM 1          // Goertzel bins of sway/shake frequency (see MotionSpectrum.h)
+#endif
+
+// Motion Sensor Driver
+#define MPU_USE_FIFO 0             // 1 = raw FIFO driver at 400 kHz (MPU INT -> MPU_INT_PIN), 0 = Adafruit_MPU6050
+#define MPU_INT_PIN 3              // Data-ready interrupt input, -1 to poll the FIFO count instead
+#define MPU_FIFO_SAMPLE_RATE 500   // Hz, on-chip sampling rate (must divide 1000)
+#define MPU_FIFO_DLPF_CFG 3        // 44 Hz accel / 42 Hz gyro, ~5 ms group delay
+#define I2C_CLOCK_HZ 400000
+#define I2C_TIMEOUT_US 3000        // Upper bound for any single I2C transaction
 
 // Motion Thresholds
 #define TILT_THRESHOLD 10.0    // Degrees - minimum tilt to trigger effects (more sensitive)
@@ -22,14 +57,59 @@
 
 // Animation Configuration
 #define TARGET_FPS 120         // Target frames per second (doubled for smoother animation)
-#define FRAME_DELAY (1000 / TARGET_FPS)
+#define FRAME_PERIOD_US (1000000UL / TARGET_FPS)  // 8333 us, kept exactly by the scheduler
+#define FRAME_DELAY (1000 / TARGET_FPS)           // Whole-ms approximation (host benchmark stepping)
+#define KALEIDOSCOPE_SYMMETRIC 1  // 1 = folds of equal length share the wave math, each keeps its own HSV conversion (same output)
+
+// Scheduler (see Scheduler.h)
+#define INPUT_PERIOD_MS 5              // Button, serial commands and auto-cycle
+#define BUTTON_DEBOUNCE_MS 30          // Button reading must hold this long
+#define STATUS_PRINT_INTERVAL_MS 2000  // Text status printout
+#define SCHEDULER_MAX_CATCH_UP 4       // Missed periods a catch-up task will still replay
+
+// Adaptive quality (see QualityGovernor.h)
+#define ENABLE_QUALITY_GOVERNOR 1
+#define GOVERNOR_BUDGET_PERCENT 90     // Render + show above this share of the period is over budget
+#define GOVERNOR_HEADROOM_PERCENT 75   // Step back up only if the predicted cost stays under this share
+#define GOVERNOR_DOWNGRADE_FRAMES 12   // Over-budget frames in a row before stepping down
+#define GOVERNOR_UPGRADE_FRAMES 120    // Frames in a row with headroom before stepping up (max 255)
+#define GOVERNOR_MAX_PERIOD_US (FRAME_PERIOD_US * 2)  // Slowest the frame rate stretches to (60 FPS)
 
 // Mode Configuration
 #define AUTO_CYCLE_MODES true  // Automatically cycle through modes
 #define MODE_DURATION_MS 20000 // Duration per mode in auto-cycle (20 seconds)
 #define RANDOM_START_MODE true // Start with random mode instead of kaleidoscope
+#define TRANSITION_STYLE TRANSITION_CROSSFADE  // TRANSITION_CROSSFADE, TRANSITION_ADDITIVE or TRANSITION_WIPE
+#define TRANSITION_DURATION_MS 600             // Both modes render plus one blend pass: ~2x a Kaleidoscope frame on the host (see Animations.h)
 
 // Calibration
-#define CALIBRATION_SAMPLES 100
+#define CALIBRATION_SAMPLES 100           // Still sensor updates averaged per calibration (1 s at MPU_UPDATE_RATE)
+#define CALIBRATION_EEPROM_ADDR 0         // Where offsets persist across power cycles
+#define CALIBRATION_TEMP_TOLERANCE 10.0   // C - stored offsets taken further from the current temperature are redone
+#define BACKGROUND_RECALIBRATION 1        // Re-measure gyro bias whenever the tube sits still
+#define STILL_GYRO_THRESHOLD 2.0          // Deg/s - max change between updates (and max calibrated rate) counted as still
+#define STILL_ACCEL_TOLERANCE 0.05        // Max deviation from 1 G counted as still
+#define CALIBRATION_SAVE_DELTA 8          // Gyro LSB (~0.12 deg/s) bias change before EEPROM is rewritten
+#define SENSOR_RETRY_MS 2000              // Retry interval while the MPU6050 is missing
+
+// Frame Profiler (Timer1-based; set to 0 to compile all instrumentation out)
+#define ENABLE_FRAME_PROFILER 1
+#define PROFILER_MAX_MODES 6   // Must cover every mode in AnimationRegistry.cpp
+#ifndef PROFILER_MARKERS
+#define PROFILER_MARKERS 0     // 1 = write frame/stage markers to a port for host/simavr (set by its build)
+#endif
+#define PROFILER_MARKER_PORT PORTL  // Pins 42-49
+#define PROFILER_MARKER_DDR DDRL
+
+// Memory monitor (stack painting and SRAM report; budgets in MemoryMonitor.h)
+#define ENABLE_MEMORY_MONITOR 1
+
+// Telemetry (binary records on Serial, decoded by host/telemetry_decode)
+#ifndef ENABLE_BINARY_TELEMETRY
+#define ENABLE_BINARY_TELEMETRY 1          // 0 = text status printout instead (blocks while Serial drains it)
+#endif
+#define TELEMETRY_RING_SIZE 128            // Bytes queued for the UART (power of two, max 128)
+#define TELEMETRY_MOTION_INTERVAL_MS 100   // Motion record rate
+#define TELEMETRY_STATUS_INTERVAL_MS 1000  // Status and power record rate
 
 #endif
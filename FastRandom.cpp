@@ -0,0 +1,19 @@
+#include "FastRandom.h"
+
+uint16_t rngState = 1;
+
+void rngSeed(uint16_t seed) {
+  rngState = seed ? seed : 0xACE1;  // Zero is xorshift's only fixed point
+}
+
+void rngFill(uint8_t* buffer, uint16_t count) {
+  uint16_t x = rngState;
+  for (uint16_t i = 0; i < count; i += 2) {
+    x ^= x << 7;
+    x ^= x >> 9;
+    x ^= x << 8;
+    buffer[i] = x >> 8;
+    if (i + 1 < count) buffer[i + 1] = x;
+  }
+  rngState = x;
+}
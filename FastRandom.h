@@ -0,0 +1,52 @@
+#ifndef FAST_RANDOM_H
+#define FAST_RANDOM_H
+
+#include <Arduino.h>
+
+// Small PRNG for per-pixel randomness (sparkles, fire cooling).
+//
+// Arduino's random() is a 32-bit LCG followed by a 32-bit modulo, several
+// hundred cycles per call on AVR. This is a 16-bit xorshift (7, 9, 8
+// triple, period 65535) whose shifts are mostly byte moves, and ranges are
+// reduced with one multiply instead of a division. Seeded explicitly, so
+// the host renderer reproduces frames exactly.
+
+extern uint16_t rngState;
+
+void rngSeed(uint16_t seed);                  // Any seed; 0 is remapped
+void rngFill(uint8_t* buffer, uint16_t count);  // count random bytes
+
+inline uint16_t rng16() {
+  uint16_t x = rngState;
+  x ^= x << 7;
+  x ^= x >> 9;
+  x ^= x << 8;
+  rngState = x;
+  return x;
+}
+
+inline uint8_t rng8() {
+  return rng16() >> 8;
+}
+
+// 0..limit-1; limit 0 always gives 0 (use rng8() for the full byte)
+inline uint8_t rng8(uint8_t limit) {
+  return ((uint16_t)rng8() * limit) >> 8;
+}
+
+// low..high-1; high must be above low
+inline uint8_t rng8(uint8_t low, uint8_t high) {
+  return low + rng8(high - low);
+}
+
+// 0..limit-1 for ranges wider than a byte; limit 0 always gives 0
+inline uint16_t rng16(uint16_t limit) {
+  return ((uint32_t)rng16() * limit) >> 16;
+}
+
+// Scale a byte from rngFill() to 0..limit-1
+inline uint8_t rngScale8(uint8_t value, uint8_t limit) {
+  return ((uint16_t)value * limit) >> 8;
+}
+
+#endif
@@ -0,0 +1,51 @@
+#include "FixedMath.h"
+
+// round(sin(k * PI / 128) * 32767) for k = 0..64
+const uint16_t SINE_QUARTER_TABLE[65] PROGMEM = {
+  0, 804, 1608, 2410, 3212, 4011, 4808, 5602,
+  6393, 7179, 7962, 8739, 9512, 10278, 11039, 11793,
+  12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+  18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+  23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+  27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+  30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971,
+  32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+  32767
+};
+
+uint16_t isqrt32(uint32_t x) {
+  uint32_t result = 0;
+  uint32_t bit = 1UL << 30;
+  while (bit > x) bit >>= 2;
+
+  while (bit) {
+    if (x >= result + bit) {
+      x -= result + bit;
+      result = (result >> 1) + bit;
+    } else {
+      result >>= 1;
+    }
+    bit >>= 2;
+  }
+  return result;
+}
+
+phase16_t iatan2(int32_t y, int32_t x) {
+  uint32_t absX = x < 0 ? -x : x;
+  uint32_t absY = y < 0 ? -y : y;
+  if (absX == 0 && absY == 0) return 0;
+
+  // Reduce to the first octant, z = tan(angle) in Q15
+  bool steep = absY > absX;
+  uint32_t num = steep ? absX : absY;
+  uint32_t den = steep ? absY : absX;
+  uint16_t z = (num << 15) / den;
+
+  // atan(z) ~ z * (PI/4 + 0.273 * (1 - z)), in phase units
+  uint16_t angle = ((uint32_t)z * (8192 + ((2847UL * (32768 - z)) >> 15))) >> 15;
+
+  if (steep) angle = 0x4000 - angle;
+  if (x < 0) angle = 0x8000 - angle;
+  if (y < 0) angle = -angle;
+  return angle;
+}
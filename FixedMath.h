@@ -0,0 +1,83 @@
+#ifndef FIXED_MATH_H
+#define FIXED_MATH_H
+
+#include <Arduino.h>
+
+// Fixed-point helpers for per-pixel animation math.
+// The ATmega2560 has no FPU, so anything evaluated per LED per frame
+// should stay in integers; float is fine for once-per-frame parameters.
+//
+// Types:
+//   phase16_t  angle where 65536 is one full turn (wraps for free)
+//   q15_t      signed fraction, -32767..32767 represents -1..1
+//   q8_8_t     signed 8.8 fixed point
+
+typedef uint16_t phase16_t;
+typedef int16_t q15_t;
+typedef int16_t q8_8_t;
+
+#define FIXED_ONE_Q8_8 256
+
+// Quarter sine wave, 64 steps + endpoint, scaled to 32767
+extern const uint16_t SINE_QUARTER_TABLE[65] PROGMEM;
+
+// Sine of a 16-bit phase, linearly interpolated from the quarter table
+inline q15_t isin16(phase16_t phase) {
+  uint8_t quadrant = phase >> 14;
+  uint16_t offset = phase & 0x3FFF;
+  if (quadrant & 1) {
+    offset = 0x4000 - offset;  // Mirror for the falling quarter
+  }
+
+  uint8_t index = offset >> 8;
+  uint8_t frac = offset & 0xFF;
+  uint16_t a = pgm_read_word(&SINE_QUARTER_TABLE[index]);
+  if (frac) {
+    uint16_t b = pgm_read_word(&SINE_QUARTER_TABLE[index + 1]);
+    a += ((uint32_t)(b - a) * frac) >> 8;
+  }
+
+  return (quadrant & 2) ? -(q15_t)a : (q15_t)a;
+}
+
+inline q15_t icos16(phase16_t phase) {
+  return isin16(phase + 0x4000);
+}
+
+// Sine mapped to 0..255, the integer form of (sin(x) + 1) * 127.5
+inline uint8_t isin8u(phase16_t phase) {
+  return ((int32_t)isin16(phase) + 32768) >> 8;
+}
+
+// Integer lerp; frac 0..255 covers t = 0..255/256
+inline uint8_t lerp8(uint8_t a, uint8_t b, uint8_t frac) {
+  if (b >= a) {
+    return a + (((uint16_t)(b - a) * frac) >> 8);
+  }
+  return a - (((uint16_t)(a - b) * frac) >> 8);
+}
+
+// Convert a float in turns (1.0 = full circle) to a phase. Once-per-frame use.
+inline phase16_t phaseFromTurns(float turns) {
+  return (phase16_t)(int32_t)((turns - floor(turns)) * 65536.0);
+}
+
+// Phase of a rotation running at turnsPerSecondQ16 (turns/s in Q16.16) at
+// time ms. Splitting whole seconds keeps the math exact in 32 bits for any
+// millis() value; rates must stay below ~65 turns/s.
+inline phase16_t phaseFromMillis(unsigned long ms, uint32_t turnsPerSecondQ16) {
+  uint32_t seconds = ms / 1000;
+  uint16_t remainder = ms % 1000;
+  return (phase16_t)(seconds * turnsPerSecondQ16 +
+                     (uint32_t)remainder * turnsPerSecondQ16 / 1000);
+}
+
+// Integer square root, floor(sqrt(x))
+uint16_t isqrt32(uint32_t x);
+
+// Angle of (x, y) as a phase (0x4000 = 90 degrees, read as int16_t for
+// -180..180). Polynomial fit, within about 0.25 degrees; |x| and |y| must
+// stay below 65536.
+phase16_t iatan2(int32_t y, int32_t x);
+
+#endif
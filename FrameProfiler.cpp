@@ -0,0 +1,182 @@
+#include "FrameProfiler.h"
+
+#if ENABLE_FRAME_PROFILER
+
+#if PROFILER_MARKERS && defined(__AVR__)
+#define MARK(code) (PROFILER_MARKER_PORT = (code))
+#else
+#define MARK(code) ((void)0)
+#endif
+
+FrameProfiler::FrameProfiler()
+  : currentMode(0), frameWorkTicks(0), inFrame(false) {
+  reset();
+}
+
+void FrameProfiler::begin() {
+#if defined(__AVR__)
+  // Free-running Timer1, normal mode, prescaler 8. This takes Timer1 away
+  // from analogWrite() on pins 11/12 and from the Servo library.
+  TCCR1A = 0;
+  TCCR1B = _BV(CS11);
+  TCCR1C = 0;
+  TIMSK1 = 0;
+#if PROFILER_MARKERS
+  PROFILER_MARKER_DDR = 0xFF;
+  PROFILER_MARKER_PORT = PROFILER_MARKER_FRAME_END;
+#endif
+#endif
+  reset();
+}
+
+void FrameProfiler::reset() {
+  memset(stats, 0, sizeof(stats));
+  for (uint8_t m = 0; m < PROFILER_MAX_MODES; m++) {
+    for (uint8_t s = 0; s < STAGE_COUNT; s++) {
+      stats[m].stages[s].minTicks = 0xFFFF;
+    }
+  }
+  frameWorkTicks = 0;
+}
+
+uint16_t FrameProfiler::now() {
+#if defined(__AVR__)
+  return TCNT1;
+#else
+  return (uint16_t)(micros() * PROFILER_TICKS_PER_US);
+#endif
+}
+
+void FrameProfiler::beginFrame(uint8_t mode) {
+  currentMode = mode < PROFILER_MAX_MODES ? mode : PROFILER_MAX_MODES - 1;
+  MARK(PROFILER_MARKER_FRAME | currentMode);
+  inFrame = true;
+}
+
+void FrameProfiler::endFrame() {
+  MARK(PROFILER_MARKER_FRAME_END);
+  recordFrame(frameWorkTicks);
+  frameWorkTicks = 0;
+  inFrame = false;
+}
+
+void FrameProfiler::beginStage(ProfileStage stage) {
+  MARK(PROFILER_MARKER_STAGE_BEGIN | stage);
+  stageStart[stage] = now();
+}
+
+void FrameProfiler::endStage(ProfileStage stage) {
+  // Unsigned subtraction handles a single counter wrap
+  uint16_t ticks = now() - stageStart[stage];
+  MARK(PROFILER_MARKER_STAGE_END | stage);
+  recordStage(stage, ticks);
+  if (!inFrame) return;
+
+  uint32_t work = (uint32_t)frameWorkTicks + ticks;
+  frameWorkTicks = work > 0xFFFF ? 0xFFFF : work;
+}
+
+void FrameProfiler::recordStage(ProfileStage stage, uint16_t ticks) {
+  StageStats& s = stats[currentMode].stages[stage];
+  if (ticks < s.minTicks) s.minTicks = ticks;
+  if (ticks > s.maxTicks) s.maxTicks = ticks;
+  s.totalTicks += ticks;
+  s.count++;
+}
+
+void FrameProfiler::recordFrame(uint16_t ticks) {
+  ModeStats& m = stats[currentMode];
+  uint16_t us = ticks / PROFILER_TICKS_PER_US;
+
+  uint8_t bucket = us / PROFILER_BUCKET_US;
+  if (bucket >= PROFILER_BUCKETS) bucket = PROFILER_BUCKETS - 1;
+
+  // Halve the whole histogram before a bucket saturates; percentiles only
+  // depend on the shape, so long runs keep working without wider counters
+  if (m.histogram[bucket] == 0xFFFF) {
+    for (uint8_t i = 0; i < PROFILER_BUCKETS; i++) {
+      m.histogram[i] >>= 1;
+    }
+  }
+  m.histogram[bucket]++;
+
+  m.frames++;
+  if (us > FRAME_BUDGET_US) {
+    m.missedDeadlines++;
+  }
+}
+
+const ModeStats& FrameProfiler::getModeStats(uint8_t mode) const {
+  return stats[mode < PROFILER_MAX_MODES ? mode : 0];
+}
+
+uint16_t FrameProfiler::getStageMinUs(uint8_t mode, ProfileStage stage) const {
+  const StageStats& s = getModeStats(mode).stages[stage];
+  return s.count ? s.minTicks / PROFILER_TICKS_PER_US : 0;
+}
+
+uint16_t FrameProfiler::getStageAvgUs(uint8_t mode, ProfileStage stage) const {
+  const StageStats& s = getModeStats(mode).stages[stage];
+  return s.count ? (s.totalTicks / s.count) / PROFILER_TICKS_PER_US : 0;
+}
+
+uint16_t FrameProfiler::getStageMaxUs(uint8_t mode, ProfileStage stage) const {
+  return getModeStats(mode).stages[stage].maxTicks / PROFILER_TICKS_PER_US;
+}
+
+// Upper edge of the histogram bucket holding the requested percentile
+uint16_t FrameProfiler::getFramePercentileUs(uint8_t mode, uint8_t percentile) const {
+  const ModeStats& m = getModeStats(mode);
+
+  uint32_t total = 0;
+  for (uint8_t i = 0; i < PROFILER_BUCKETS; i++) {
+    total += m.histogram[i];
+  }
+  if (total == 0) return 0;
+
+  uint32_t target = (total * percentile + 99) / 100;
+  uint32_t cumulative = 0;
+  for (uint8_t i = 0; i < PROFILER_BUCKETS; i++) {
+    cumulative += m.histogram[i];
+    if (cumulative >= target) {
+      return (i + 1) * PROFILER_BUCKET_US;
+    }
+  }
+  return PROFILER_BUCKETS * PROFILER_BUCKET_US;
+}
+
+void FrameProfiler::printReport(const char* (*modeName)(uint8_t mode), uint8_t numModes) const {
+  static const char* const stageNames[STAGE_COUNT] = { "sensor", "render", "show" };
+
+  Serial.println("=== Frame Profile (us: min/avg/max) ===");
+  for (uint8_t mode = 0; mode < numModes && mode < PROFILER_MAX_MODES; mode++) {
+    const ModeStats& m = stats[mode];
+    if (m.frames == 0) continue;
+
+    Serial.print(modeName(mode));
+    Serial.print(": frames=");
+    Serial.print(m.frames);
+    Serial.print(" p99=");
+    Serial.print(getFramePercentileUs(mode, 99));
+    Serial.print(" missed=");
+    Serial.println(m.missedDeadlines);
+
+    for (uint8_t s = 0; s < STAGE_COUNT; s++) {
+      ProfileStage stage = (ProfileStage)s;
+      Serial.print("  ");
+      Serial.print(stageNames[s]);
+      Serial.print(": ");
+      Serial.print(getStageMinUs(mode, stage));
+      Serial.print("/");
+      Serial.print(getStageAvgUs(mode, stage));
+      Serial.print("/");
+      Serial.println(getStageMaxUs(mode, stage));
+    }
+  }
+  Serial.print("Budget: ");
+  Serial.print(FRAME_BUDGET_US);
+  Serial.println(" us/frame");
+  Serial.println();
+}
+
+#endif
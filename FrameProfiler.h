@@ -0,0 +1,102 @@
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+#include <Arduino.h>
+#include "Config.h"
+
+// Pipeline stages timed by the profiler
+enum ProfileStage {
+  STAGE_SENSOR,   // MotionProcessor::update(); its own task, between frames
+  STAGE_RENDER,   // runCurrentAnimation()
+  STAGE_SHOW,     // LEDController::show()
+  STAGE_COUNT
+};
+
+#if ENABLE_FRAME_PROFILER
+
+// Timer1 runs free at F_CPU/8: one tick is 0.5us at 16 MHz and the 16-bit
+// counter wraps every 32.7 ms, comfortably longer than any single stage.
+#define PROFILER_TICKS_PER_US 2
+#define PROFILER_BUCKET_US 500       // Histogram resolution for p99
+#define PROFILER_BUCKETS 25          // 0-12 ms in 0.5 ms steps, last bucket is overflow
+#define FRAME_BUDGET_US (1000000UL / TARGET_FPS)
+
+// With PROFILER_MARKERS every bracket also writes a code to
+// PROFILER_MARKER_PORT, where a simulator can stamp it with the exact
+// cycle (host/simavr/avr_bench): frame begin 0x40 | mode, stage begin
+// 0x80 | stage, stage end 0xC0 | stage, frame end 0x00. Consecutive codes
+// always differ, so a port-change watch sees every one.
+#define PROFILER_MARKER_FRAME 0x40
+#define PROFILER_MARKER_STAGE_BEGIN 0x80
+#define PROFILER_MARKER_STAGE_END 0xC0
+#define PROFILER_MARKER_FRAME_END 0x00
+
+struct StageStats {
+  uint16_t minTicks;
+  uint16_t maxTicks;
+  uint32_t totalTicks;
+  uint32_t count;
+};
+
+struct ModeStats {
+  StageStats stages[STAGE_COUNT];
+  uint16_t histogram[PROFILER_BUCKETS];  // Frame work time (stages inside the frame)
+  uint32_t frames;
+  uint32_t missedDeadlines;              // Frames whose work exceeded FRAME_BUDGET_US
+};
+
+class FrameProfiler {
+public:
+  FrameProfiler();
+
+  void begin();
+  void reset();
+
+  // Frame bracketing; stages recorded in between are charged to the mode
+  // and add up to the frame's work. A stage outside any frame (the sensor
+  // task) is charged to the mode last framed but kept out of frame work,
+  // so the histogram and missed deadlines cover render and show only.
+  void beginFrame(uint8_t mode);
+  void endFrame();
+
+  void beginStage(ProfileStage stage);
+  void endStage(ProfileStage stage);
+
+  // Queries (all times in microseconds)
+  const ModeStats& getModeStats(uint8_t mode) const;
+  uint16_t getStageMinUs(uint8_t mode, ProfileStage stage) const;
+  uint16_t getStageAvgUs(uint8_t mode, ProfileStage stage) const;
+  uint16_t getStageMaxUs(uint8_t mode, ProfileStage stage) const;
+  uint16_t getFramePercentileUs(uint8_t mode, uint8_t percentile) const;
+
+  void printReport(const char* (*modeName)(uint8_t mode), uint8_t numModes) const;
+
+private:
+  ModeStats stats[PROFILER_MAX_MODES];
+  uint8_t currentMode;
+  uint16_t stageStart[STAGE_COUNT];
+  uint16_t frameWorkTicks;  // Accumulated stage ticks for the current frame
+  bool inFrame;
+
+  static uint16_t now();
+  void recordStage(ProfileStage stage, uint16_t ticks);
+  void recordFrame(uint16_t ticks);
+};
+
+extern FrameProfiler frameProfiler;
+
+#define PROFILE_FRAME_BEGIN(mode) frameProfiler.beginFrame(mode)
+#define PROFILE_FRAME_END() frameProfiler.endFrame()
+#define PROFILE_STAGE_BEGIN(stage) frameProfiler.beginStage(stage)
+#define PROFILE_STAGE_END(stage) frameProfiler.endStage(stage)
+
+#else
+
+#define PROFILE_FRAME_BEGIN(mode) ((void)0)
+#define PROFILE_FRAME_END() ((void)0)
+#define PROFILE_STAGE_BEGIN(stage) ((void)0)
+#define PROFILE_STAGE_END(stage) ((void)0)
+
+#endif
+
+#endif
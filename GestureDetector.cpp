@@ -0,0 +1,143 @@
+#include "GestureDetector.h"
+#include "FixedMath.h"
+
+GestureDetector::GestureDetector() {
+  reset();
+}
+
+void GestureDetector::reset() {
+  accelDeviation.reset();
+  yawRate.reset();
+  shake.reset();
+  tilt.reset();
+  tapMicros = 0;
+  flickMicros = 0;
+  flickDirection = 0;
+  tiltSteadySince = 0;
+  tiltSteady = false;
+  tiltArmed = true;
+  shakeArmed = true;
+  lastTapMillis = 0;
+  queueHead = 0;
+  queueCount = 0;
+  lastEvent.type = GESTURE_NONE;
+  lastEvent.millis = 0;
+}
+
+void GestureDetector::addSample(const RawMotionSample& sample, uint16_t dtMicros) {
+  // Accelerometer magnitude's distance from 1 g, in mg
+  int32_t ax = sample.accelX, ay = sample.accelY, az = sample.accelZ;
+  uint32_t squares = (uint32_t)(ax * ax) + (uint32_t)(ay * ay) + (uint32_t)(az * az);
+  int32_t deviation = abs((int32_t)isqrt32(squares) - MPU_ACCEL_LSB_PER_G) * 1000L / MPU_ACCEL_LSB_PER_G;
+
+  int16_t rate = (int32_t)sample.gyroZ * 10 / MPU_GYRO_LSB_PER_DPS_X10;  // deg/s
+  int16_t speed = abs(rate);
+
+  // Tap: a short spike out of a quiet window (the window doesn't hold
+  // this sample yet, so its mean is what came before)
+  if (tapMicros == 0) {
+    if (deviation > GESTURE_TAP_MG && accelDeviation.full() && accelDeviation.mean() < GESTURE_QUIET_MG) {
+      tapMicros = dtMicros;
+    }
+  } else if (deviation < GESTURE_TAP_MG / 2) {
+    if (tapMicros <= GESTURE_TAP_MAX_MS * 1000UL) {
+      emit(GESTURE_TAP);
+      // lastTapMillis 0 = no first tap waiting for its second
+      if (lastTapMillis != 0 && lastEvent.millis - lastTapMillis <= GESTURE_DOUBLE_TAP_MS) {
+        emit(GESTURE_DOUBLE_TAP);
+        lastTapMillis = 0;
+      } else {
+        lastTapMillis = lastEvent.millis;
+      }
+    }
+    tapMicros = 0;
+  } else {
+    tapMicros += dtMicros;
+  }
+
+  // Flick: a short burst of yaw rate out of a slow window
+  if (flickMicros == 0) {
+    if (speed > GESTURE_FLICK_DPS && yawRate.full() && yawRate.mean() < GESTURE_PAN_DPS) {
+      flickMicros = dtMicros;
+      flickDirection = rate > 0 ? 1 : -1;
+    }
+  } else if (speed < GESTURE_FLICK_DPS / 2) {
+    if (flickMicros <= GESTURE_FLICK_MAX_MS * 1000UL) {
+      emit(flickDirection > 0 ? GESTURE_FLICK_CCW : GESTURE_FLICK_CW);
+    }
+    flickMicros = 0;
+  } else {
+    flickMicros += dtMicros;
+  }
+
+  accelDeviation.add(deviation);
+  yawRate.add(speed);
+}
+
+void GestureDetector::addUpdate(float shakeG, float tiltDegrees) {
+  shake.add(shakeG * 1000);
+  tilt.add(tiltDegrees);
+
+  // Shake: mean square over the window (variance + mean^2) against the
+  // RMS threshold; re-armed at half the RMS
+  int32_t shakeMean = shake.mean();
+  uint32_t shakeEnergy = shake.variance() + (uint32_t)(shakeMean * shakeMean);
+  const uint32_t shakeThreshold = (uint32_t)GESTURE_SHAKE_MG * GESTURE_SHAKE_MG;
+  if (shakeArmed && shake.full() && shakeEnergy > shakeThreshold) {
+    emit(GESTURE_SHAKE);
+    shakeArmed = false;
+  } else if (!shakeArmed && shakeEnergy < shakeThreshold / 4) {
+    shakeArmed = true;
+  }
+
+  // Tilt hold: past the angle and steady for the whole hold time
+  if (tilt.newest() < GESTURE_TILT_DEG) {
+    tiltSteady = false;
+    tiltArmed = true;
+  } else if (tilt.variance() <= (uint32_t)GESTURE_TILT_STEADY_DEG * GESTURE_TILT_STEADY_DEG) {
+    unsigned long now = millis();
+    if (!tiltSteady) {
+      tiltSteady = true;
+      tiltSteadySince = now;
+    } else if (tiltArmed && now - tiltSteadySince >= GESTURE_TILT_HOLD_MS) {
+      emit(GESTURE_TILT_HOLD);
+      tiltArmed = false;
+    }
+  } else {
+    tiltSteady = false;
+  }
+}
+
+bool GestureDetector::poll(GestureEvent& event) {
+  if (queueCount == 0) return false;
+
+  event = queue[queueHead];
+  queueHead = (queueHead + 1) % GESTURE_QUEUE_SIZE;
+  queueCount--;
+  return true;
+}
+
+// A full queue loses its oldest event
+void GestureDetector::emit(GestureType type) {
+  lastEvent.type = type;
+  lastEvent.millis = millis();
+
+  if (queueCount == GESTURE_QUEUE_SIZE) {
+    queueHead = (queueHead + 1) % GESTURE_QUEUE_SIZE;
+    queueCount--;
+  }
+  queue[(queueHead + queueCount) % GESTURE_QUEUE_SIZE] = lastEvent;
+  queueCount++;
+}
+
+const char* GestureDetector::name(GestureType type) {
+  switch (type) {
+    case GESTURE_TAP: return "tap";
+    case GESTURE_DOUBLE_TAP: return "double tap";
+    case GESTURE_FLICK_CCW: return "flick CCW";
+    case GESTURE_FLICK_CW: return "flick CW";
+    case GESTURE_TILT_HOLD: return "tilt hold";
+    case GESTURE_SHAKE: return "shake";
+    default: return "none";
+  }
+}
@@ -0,0 +1,111 @@
+#ifndef GESTURE_DETECTOR_H
+#define GESTURE_DETECTOR_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include "MotionSample.h"
+#include "WindowStats.h"
+
+// Gesture detection on windowed motion statistics (ENABLE_GESTURES).
+//
+// Every IMU sample (500 Hz with the FIFO driver, MPU_UPDATE_RATE without)
+// feeds two short windows: the
+// accelerometer magnitude's distance from 1 g, and the absolute yaw rate.
+// Every sensor update (MPU_UPDATE_RATE) feeds two longer ones: the batch
+// shake and the fused tilt angle. Each sample costs a fixed amount of
+// work (one isqrt32 plus the window updates).
+//
+//   Tap         A spike above GESTURE_TAP_MG that ends within
+//               GESTURE_TAP_MAX_MS, after a quiet window
+//   Double tap  A second tap within GESTURE_DOUBLE_TAP_MS (the tap itself
+//               is reported too)
+//   Flick       A yaw rate above GESTURE_FLICK_DPS that starts from a slow
+//               window and ends within GESTURE_FLICK_MAX_MS; CCW is a
+//               positive yawRate
+//   Tilt hold   Tilt above GESTURE_TILT_DEG held steady for
+//               GESTURE_TILT_HOLD_MS; re-armed once the tube comes back
+//   Shake       The update window's RMS shake rises past GESTURE_SHAKE_MG;
+//               re-armed when it falls to half
+//
+// Events are stamped with millis() and queued until poll()ed; the newest
+// one is also copied into MotionData for the animations.
+
+#define GESTURE_SAMPLE_WINDOW 16     // IMU samples (32 ms at 500 Hz, 160 ms at 100 Hz)
+#define GESTURE_UPDATE_WINDOW 32     // Sensor updates (320 ms at 100 Hz)
+#define GESTURE_QUEUE_SIZE 4
+
+#define GESTURE_TAP_MG 1500
+#define GESTURE_QUIET_MG 250         // Mean deviation before a tap
+#define GESTURE_TAP_MAX_MS 40
+#define GESTURE_DOUBLE_TAP_MS 400
+#define GESTURE_FLICK_DPS 250
+#define GESTURE_PAN_DPS 60           // Mean yaw rate before a flick
+#define GESTURE_FLICK_MAX_MS 300
+#define GESTURE_TILT_DEG 35
+#define GESTURE_TILT_STEADY_DEG 4    // Standard deviation over the window
+#define GESTURE_TILT_HOLD_MS 2000
+#define GESTURE_SHAKE_MG 400
+
+enum GestureType : uint8_t {
+  GESTURE_NONE,
+  GESTURE_TAP,
+  GESTURE_DOUBLE_TAP,
+  GESTURE_FLICK_CCW,
+  GESTURE_FLICK_CW,
+  GESTURE_TILT_HOLD,
+  GESTURE_SHAKE
+};
+
+struct GestureEvent {
+  GestureType type;
+  unsigned long millis;  // When it was recognised
+};
+
+class GestureDetector {
+public:
+  GestureDetector();
+  void reset();
+
+  // One calibrated IMU sample and the time it covers
+  void addSample(const RawMotionSample& sample, uint16_t dtMicros);
+
+  // Once per sensor update: batch shake (|a| - 1 g, in g) and tilt in degrees
+  void addUpdate(float shakeG, float tiltDegrees);
+
+  // Oldest undelivered event; false when none is waiting
+  bool poll(GestureEvent& event);
+  const GestureEvent& last() const { return lastEvent; }
+
+  // The windows, for animations that want more than events
+  const WindowStats<GESTURE_SAMPLE_WINDOW>& accelStats() const { return accelDeviation; }  // mg
+  const WindowStats<GESTURE_SAMPLE_WINDOW>& yawStats() const { return yawRate; }          // |deg/s|
+  const WindowStats<GESTURE_UPDATE_WINDOW>& shakeStats() const { return shake; }          // mg
+  const WindowStats<GESTURE_UPDATE_WINDOW>& tiltStats() const { return tilt; }            // degrees
+
+  static const char* name(GestureType type);
+
+private:
+  WindowStats<GESTURE_SAMPLE_WINDOW> accelDeviation;
+  WindowStats<GESTURE_SAMPLE_WINDOW> yawRate;
+  WindowStats<GESTURE_UPDATE_WINDOW> shake;
+  WindowStats<GESTURE_UPDATE_WINDOW> tilt;
+
+  // Gestures in progress; durations in microseconds, 0 = not active
+  uint32_t tapMicros;
+  uint32_t flickMicros;
+  int8_t flickDirection;
+  unsigned long tiltSteadySince;
+  bool tiltSteady;
+  bool tiltArmed;
+  bool shakeArmed;
+  unsigned long lastTapMillis;
+
+  GestureEvent queue[GESTURE_QUEUE_SIZE];
+  uint8_t queueHead;
+  uint8_t queueCount;
+  GestureEvent lastEvent;
+
+  void emit(GestureType type);
+};
+
+#endif
@@ -1,55 +1,240 @@
 #include "LEDController.h"
+#include "FixedMath.h"
+#if defined(__AVR__)
+#include <util/crc16.h>
+#endif
 
-LEDController::LEDController() {
+#if ENABLE_POWER_LIMIT
+static_assert(POWER_BUDGET_MA > NUM_LEDS * LED_IDLE_MA, "POWER_BUDGET_MA must cover the strip's idle draw");
+#endif
+
+void FrameBuffer::reset() {
+#if LED_INDEXED_FRAMEBUFFER
+  paletteWraps = false;
+  indexed = false;
+  fill_solid(palette, 16, CRGB::Black);
+#endif
+#if LED_SKIP_UNCHANGED_FRAMES
+  solid = false;
+#endif
+}
+
+LEDController::LEDController()
+  : frame(&shown), brightness(DEFAULT_BRIGHTNESS) {
+  shown.reset();
+#if LED_SKIP_UNCHANGED_FRAMES
+  dirty = true;
+  shownHash = 0;
+  lastSendMillis = 0;
+  skippedFrames = 0;
+#endif
+#if ENABLE_POWER_LIMIT
+  requestedMilliamps = 0;
+  drawnMilliamps = 0;
+  limitedFrames = 0;
+  channelSum = 0;
+#endif
   initializeSegments();
 }
 
 void LEDController::begin() {
+#if LED_PARALLEL_OUTPUT
+  output.begin();
+#else
   // WS2818 uses WS2812B protocol with GRB color order
-  FastLED.addLeds<WS2812B, LED_PIN, GRB>(leds, NUM_LEDS);
-  FastLED.setBrightness(DEFAULT_BRIGHTNESS);
+  FastLED.addLeds<WS2812B, LED_PIN, GRB>(shown.pixels, NUM_LEDS);
+#endif
+  setBrightness(DEFAULT_BRIGHTNESS);
   clear();
   show();
   Serial.println("LED Controller initialized");
 }
 
 void LEDController::initializeSegments() {
-  // Define the three segments based on the back-and-forth layout
-  // For 209 LEDs: 70 + 70 + 69
-  // Segment 0: LEDs 0-69 (forward)
-  segments[0].start = 0;
-  segments[0].end = 69;
-  segments[0].length = 70;
-  segments[0].reversed = false;
-
-  // Segment 1: LEDs 70-139 (backward - folded back)
-  segments[1].start = 70;
-  segments[1].end = 139;
-  segments[1].length = 70;
-  segments[1].reversed = true;
-
-  // Segment 2: LEDs 140-208 (forward again)
-  segments[2].start = 140;
-  segments[2].end = 208;
-  segments[2].length = 69;
-  segments[2].reversed = false;
+  // Layout comes from SegmentLayout.h (derived from NUM_LEDS / NUM_SEGMENTS)
+  for (uint8_t i = 0; i < NUM_SEGMENTS; i++) {
+    segments[i].start = SegmentLayout::start(i);
+    segments[i].end = SegmentLayout::end(i);
+    segments[i].length = SegmentLayout::length(i);
+    segments[i].reversed = SegmentLayout::reversed(i);
+  }
 }
 
 void LEDController::setBrightness(uint8_t brightness) {
-  FastLED.setBrightness(constrain(brightness, 0, MAX_BRIGHTNESS));
+  brightness = constrain(brightness, 0, MAX_BRIGHTNESS);
+  if (brightness != this->brightness) markDirty();
+  this->brightness = brightness;
+  FastLED.setBrightness(this->brightness);
 }
 
 void LEDController::clear() {
   fill(CRGB::Black);
 }
 
-void LEDController::show() {
+bool LEDController::show() {
+#if LED_SKIP_UNCHANGED_FRAMES
+  // Untouched, or rewritten to the same content: the strip already shows it
+  unsigned long now = millis();
+  bool refreshDue = now - lastSendMillis >= LED_REFRESH_MS;
+  if (dirty) {
+    dirty = false;
+    uint16_t hash = scanFrame();
+    if (hash != shownHash) {
+      shownHash = hash;
+      refreshDue = true;
+    }
+  }
+  if (!refreshDue) {
+    skippedFrames++;
+    return false;
+  }
+  lastSendMillis = now;
+#elif ENABLE_POWER_LIMIT
+  scanFrame();
+#endif
+
+#if ENABLE_POWER_LIMIT
+  // An undirtied frame is the one last scanned, so its sum still holds
+  uint8_t frameBrightness = limitBrightness();
+#else
+  uint8_t frameBrightness = brightness;
+#endif
+
+#if LED_PARALLEL_OUTPUT
+  // Every segment on its own pin at once; blocks like FastLED.show()
+  flushIndexed();
+  output.show(shown.pixels, frameBrightness);
+#else
+  flushIndexed();
+  FastLED.setBrightness(frameBrightness);
   FastLED.show();
+#endif
+  return true;
+}
+
+#if LED_SKIP_UNCHANGED_FRAMES
+// CRC-CCITT step (reflected 0x1021); avr-libc has it as inline asm
+static inline uint16_t crcUpdate(uint16_t crc, uint8_t data) {
+#if defined(__AVR__)
+  return _crc_ccitt_update(crc, data);
+#else
+  data ^= crc & 0xFF;
+  data ^= data << 4;
+  return (((uint16_t)data << 8) | (crc >> 8)) ^ (uint8_t)(data >> 4) ^ ((uint16_t)data << 3);
+#endif
+}
+#endif
+
+#if LED_SKIP_UNCHANGED_FRAMES || ENABLE_POWER_LIMIT
+// One pass over the frame for both things show() needs from it: the CRC
+// of its source bytes and brightness (returned), and the sum of every
+// channel value before brightness, for the power limit (in channelSum).
+// Unlike a sum the CRC sees pixels trading places (sparkles moving); an
+// unrelated frame still collides 1 time in 65536, which costs one stale
+// frame period.
+uint16_t LEDController::scanFrame() {
+  uint16_t crc = 0xFFFF;
+#if LED_SKIP_UNCHANGED_FRAMES
+  crc = crcUpdate(crc, brightness);
+#endif
+
+#if LED_INDEXED_FRAMEBUFFER
+  if (shown.indexed) {
+    bool wraps = shown.paletteWraps;
+#if LED_SKIP_UNCHANGED_FRAMES
+    const uint8_t* colors = (const uint8_t*)shown.palette;
+    for (uint8_t i = 0; i < sizeof(shown.palette); i++) {
+      crc = crcUpdate(crc, colors[i]);
+    }
+    crc = crcUpdate(crc, wraps ? 0x5A : 0xA5);
+#endif
+
+#if ENABLE_POWER_LIMIT
+    // Channel sums are linear in the palette blend, so the frame's sum
+    // follows from how many LEDs sit on each entry and how far towards
+    // the next one they are: two counters per LED, the rest per entry
+    uint16_t entryCount[16] = {0};
+    uint16_t entryFraction[16] = {0};  // Sixteenths towards the next entry
+#endif
+    const uint8_t* indexes = shown.indices();
+    for (uint16_t i = 0; i < NUM_LEDS; i++) {
+      uint8_t index = indexes[i];
+#if LED_SKIP_UNCHANGED_FRAMES
+      crc = crcUpdate(crc, index);
+#endif
+#if ENABLE_POWER_LIMIT
+      if (!wraps) index = scale8(index, 240);
+      entryCount[index >> 4]++;
+      entryFraction[index >> 4] += index & 0x0F;
+#endif
+    }
+
+#if ENABLE_POWER_LIMIT
+    uint32_t sum = 0;
+    for (uint8_t k = 0; k < 16; k++) {
+      uint16_t a = (uint16_t)shown.palette[k].r + shown.palette[k].g + shown.palette[k].b;
+      sum += (uint32_t)entryCount[k] * a;
+      // The last entry only blends into the first when the palette wraps
+      if (k == 15 && !wraps) break;
+      const CRGB& next = shown.palette[(k + 1) & 0x0F];
+      int16_t b = (uint16_t)next.r + next.g + next.b;
+      sum += ((int32_t)(b - a) * entryFraction[k]) >> 4;
+    }
+    channelSum = sum;
+#endif
+    return crc;
+  }
+#endif
+
+#if ENABLE_POWER_LIMIT
+  uint32_t sum = 0;
+#endif
+  for (uint16_t i = 0; i < NUM_LEDS; i++) {
+    const CRGB& pixel = shown.pixels[i];
+#if LED_SKIP_UNCHANGED_FRAMES
+    crc = crcUpdate(crcUpdate(crcUpdate(crc, pixel.r), pixel.g), pixel.b);
+#endif
+#if ENABLE_POWER_LIMIT
+    sum += (uint16_t)pixel.r + pixel.g + pixel.b;
+#endif
+  }
+#if ENABLE_POWER_LIMIT
+  channelSum = sum;
+#endif
+  return crc;
+}
+#endif
+
+#if ENABLE_POWER_LIMIT
+// Brightness for this frame: the configured one unless the frame would
+// draw more than POWER_BUDGET_MA
+uint8_t LEDController::limitBrightness() {
+  const uint32_t idleMilliamps = (uint32_t)NUM_LEDS * LED_IDLE_MA;
+
+  // Draw of the lit part at brightness 255
+  uint32_t fullMilliamps = channelSum * LED_MA_PER_CHANNEL / 255;
+  uint32_t requested = idleMilliamps + fullMilliamps * brightness / 255;
+  uint8_t scaled = brightness;
+
+  if (requested > POWER_BUDGET_MA) {
+    scaled = (POWER_BUDGET_MA - idleMilliamps) * 255 / fullMilliamps;
+    limitedFrames++;
+  }
+
+  requestedMilliamps = requested > 0xFFFF ? 0xFFFF : requested;
+  drawnMilliamps = idleMilliamps + fullMilliamps * scaled / 255;
+  return scaled;
+}
+#endif
+
+unsigned long LEDController::photonDelayMicros() const {
+  return WS2812_LATCH_US;  // show() blocks until the frame is on the wire
 }
 
 void LEDController::setPixel(uint16_t index, CRGB color) {
+  beginWrite();
   if (index < NUM_LEDS) {
-    leds[index] = color;
+    frame->pixels[index] = color;
   }
 }
 
@@ -59,7 +244,7 @@ void LEDController::setPixel(uint16_t index, uint8_t r, uint8_t g, uint8_t b) {
 
 CRGB LEDController::getPixel(uint16_t index) const {
   if (index < NUM_LEDS) {
-    return leds[index];
+    return frame->color(index);
   }
   return CRGB::Black;
 }
@@ -95,8 +280,52 @@ Segment LEDController::getSegment(uint8_t segment) const {
   return segments[0];
 }
 
+SegmentSpan LEDController::segmentSpan(uint8_t segment) {
+  if (segment >= NUM_SEGMENTS) segment = 0;
+
+  beginWrite();
+  const Segment& seg = segments[segment];
+  if (seg.reversed) {
+    return SegmentSpan(&frame->pixels[seg.end], -1, seg.length);
+  }
+  return SegmentSpan(&frame->pixels[seg.start], 1, seg.length);
+}
+
+void LEDController::replicateSegment(uint8_t source, uint8_t target, const SegmentTransform& transform) {
+  if (source >= NUM_SEGMENTS || target >= NUM_SEGMENTS || source == target) return;
+
+  SegmentSpan from = segmentSpan(source);
+  SegmentSpan to = segmentSpan(target);
+  uint16_t last = from.size() - 1;
+
+  // Source position in Q16.16, stepping the source length per target length
+  uint32_t wrap = (uint32_t)from.size() << 16;
+  uint32_t step = wrap / to.size();
+  uint32_t position = (uint32_t)transform.phase * from.size();
+
+  for (CRGB& pixel : to) {
+    uint16_t p = position >> 16;
+    CRGB color = from[transform.mirror ? last - p : p];
+    if (transform.brightness != 255) color.nscale8(transform.brightness);
+
+    pixel = color;
+    position += step;
+    if (position >= wrap) position -= wrap;
+  }
+}
+
 void LEDController::fill(CRGB color) {
-  fill_solid(leds, NUM_LEDS, color);
+#if LED_SKIP_UNCHANGED_FRAMES
+  // Repeating the solid fill already in the buffer changes nothing
+  if (frame->solid && color == frame->solidColor) return;
+  dirty = true;
+  frame->solid = true;
+  frame->solidColor = color;
+#endif
+#if LED_INDEXED_FRAMEBUFFER
+  frame->indexed = false;  // Fully overwritten, no need to expand
+#endif
+  fill_solid(frame->pixels, NUM_LEDS, color);
 }
 
 void LEDController::fillSegment(uint8_t segment, CRGB color) {
@@ -109,28 +338,42 @@ void LEDController::fillSegment(uint8_t segment, CRGB color) {
 void LEDController::fillRange(uint16_t start, uint16_t end, CRGB color) {
   if (start >= NUM_LEDS) return;
   if (end >= NUM_LEDS) end = NUM_LEDS - 1;
+  beginWrite();
 
   for (uint16_t i = start; i <= end; i++) {
-    leds[i] = color;
+    frame->pixels[i] = color;
   }
 }
 
 void LEDController::fillGradient(CRGB startColor, CRGB endColor) {
-  fill_gradient_RGB(leds, 0, startColor, NUM_LEDS - 1, endColor);
+  beginWrite();
+  fill_gradient_RGB(frame->pixels, 0, startColor, NUM_LEDS - 1, endColor);
 }
 
 void LEDController::fillGradientSegment(uint8_t segment, CRGB startColor, CRGB endColor) {
   if (segment >= NUM_SEGMENTS) return;
 
   const Segment& seg = segments[segment];
+  beginWrite();
 
   // For reversed segments, swap colors to maintain visual direction
   if (seg.reversed) {
-    fill_gradient_RGB(leds, seg.start, endColor, seg.end, startColor);
+    fill_gradient_RGB(frame->pixels, seg.start, endColor, seg.end, startColor);
   } else {
-    fill_gradient_RGB(leds, seg.start, startColor, seg.end, endColor);
+    fill_gradient_RGB(frame->pixels, seg.start, startColor, seg.end, endColor);
+  }
+}
+
+#if LED_INDEXED_FRAMEBUFFER
+// In place: see FrameBuffer::indices()
+void LEDController::expandIndexed() {
+  frame->indexed = false;
+  const uint8_t* index = frame->indices();
+  for (uint16_t i = 0; i < NUM_LEDS; i++) {
+    frame->pixels[i] = frame->paletteColor(index[i]);
   }
 }
+#endif
 
 // Color wheel: input 0-255 to get rainbow colors
 CRGB LEDController::wheel(uint8_t pos) {
@@ -3,6 +3,11 @@
 
 #include <FastLED.h>
 #include "Config.h"
+#include "SegmentLayout.h"
+#include "FixedMath.h"
+#if LED_PARALLEL_OUTPUT
+#include "ParallelLEDOutput.h"
+#endif
 
 // Segment definition
 struct Segment {
@@ -12,6 +17,66 @@ struct Segment {
   bool reversed;    // Whether segment is reversed in physical layout
 };
 
+// How replicateSegment() derives one segment from another. Positions are
+// logical (SegmentSpan order) and resampled when the lengths differ.
+struct SegmentTransform {
+  bool mirror;          // Target position 0 takes the source's last pixel
+  uint8_t brightness;   // scale8() factor, 255 = unchanged
+  uint16_t phase;       // Shift along the source, 65536 = one whole segment (wraps)
+};
+
+// One frame as rendered: the pixels and, for an indexed frame, the
+// palette its indices refer to. LEDController owns the frame that is
+// shown; a transition renders the outgoing mode into a second one (see
+// LEDController::renderInto()).
+struct FrameBuffer {
+  CRGB pixels[NUM_LEDS];
+#if LED_INDEXED_FRAMEBUFFER
+  CRGB palette[16];
+  bool paletteWraps;
+  bool indexed;  // The indices hold the frame, pixels[] is stale
+
+  // The indices take the last NUM_LEDS bytes of pixels[] rather than a
+  // buffer of their own. Expanding in ascending order is safe in place:
+  // pixel i's 3 bytes end at or before index i, which has been read by then.
+  uint8_t* indices() { return (uint8_t*)pixels + sizeof(pixels) - NUM_LEDS; }
+  const uint8_t* indices() const { return (const uint8_t*)pixels + sizeof(pixels) - NUM_LEDS; }
+  CRGB paletteColor(uint8_t index) const;
+#endif
+#if LED_SKIP_UNCHANGED_FRAMES
+  bool solid;  // Holds a single fill() of solidColor
+  CRGB solidColor;
+#endif
+
+  void reset();
+
+  // Pixel i as it will look, indexed or not. A pass that reads color(i)
+  // and then writes pixels[i], in ascending i, is safe on an indexed
+  // frame; clear indexed once it is done.
+  CRGB color(uint16_t i) const {
+#if LED_INDEXED_FRAMEBUFFER
+    if (indexed) return paletteColor(indices()[i]);
+#endif
+    return pixels[i];
+  }
+};
+
+#if LED_INDEXED_FRAMEBUFFER
+// Inline: show() and composite() call it once per LED
+inline CRGB FrameBuffer::paletteColor(uint8_t index) const {
+  // Non-wrapping palettes spread entry k to index k * 17 so both ends are exact
+  if (!paletteWraps) index = scale8(index, 240);
+
+  uint8_t entry = index >> 4;
+  uint8_t frac = (index & 0x0F) << 4;
+  const CRGB& a = palette[entry];
+  if (frac == 0 || (entry == 15 && !paletteWraps)) return a;
+
+  const CRGB& b = palette[(entry + 1) & 0x0F];
+  return CRGB(lerp8(a.r, b.r, frac), lerp8(a.g, b.g, frac), lerp8(a.b, b.b, frac));
+}
+#endif
+
 class LEDController {
 public:
   LEDController();
@@ -19,16 +84,65 @@ public:
   void begin();
   void setBrightness(uint8_t brightness);
   void clear();
-  void show();
+  bool show();  // False if the frame matched the last one sent and was skipped
+  unsigned long photonDelayMicros() const;  // From show() returning until the frame is latched
+
+#if LED_SKIP_UNCHANGED_FRAMES
+  // Change tracking: every write marks the frame dirty, and a dirty frame
+  // is hashed at show() so one that comes out identical still isn't sent.
+  // fill() with the solid colour already in the buffer writes nothing, so
+  // steady strobe, pulse and error frames skip both the fill and the hash.
+  bool isDirty() const { return dirty; }
+  uint32_t getSkippedFrames() const { return skippedFrames; }
+#endif
+
+#if ENABLE_POWER_LIMIT
+  // Power model for the last frame shown. Frames estimated above
+  // POWER_BUDGET_MA are dimmed just enough to fit; others go out untouched.
+  uint16_t getRequestedMilliamps() const { return requestedMilliamps; }  // Before limiting
+  uint16_t getDrawnMilliamps() const { return drawnMilliamps; }          // After limiting
+  int16_t getPowerHeadroomMilliamps() const { return (int16_t)POWER_BUDGET_MA - drawnMilliamps; }
+  uint32_t getLimitedFrames() const { return limitedFrames; }
+#endif
 
   // Direct LED access
   void setPixel(uint16_t index, CRGB color);
   void setPixel(uint16_t index, uint8_t r, uint8_t g, uint8_t b);
   CRGB getPixel(uint16_t index) const;
+  CRGB* pixels() { beginWrite(); return frame->pixels; }  // Raw render buffer for whole-frame passes
+
+  // Render target: every write goes to target until renderInto(nullptr)
+  // points them back at the frame that is shown. The frame that is shown
+  // is the only one hashed, power-limited and sent.
+  void renderInto(FrameBuffer* target) { frame = target ? target : &shown; }
+
+  // The current target as it stands, for whole-frame passes that combine
+  // it with another buffer without expanding it first (see
+  // FrameBuffer::color())
+  FrameBuffer& frameBuffer() { markWritten(); return *frame; }
+
+#if LED_INDEXED_FRAMEBUFFER
+  // Indexed rendering: write one palette index per LED through
+  // indexBuffer() and the frame is expanded through the 16-entry palette
+  // at show(). Wrapping palettes (hue wheels) put entry k at index k * 16
+  // and blend from entry 15 back to entry 0; non-wrapping ones (ramps) put
+  // entry k at index k * 17 so 0 and 255 hit the end entries exactly.
+  // Palette edits are O(16) no matter how many LEDs use them. Any CRGB
+  // write expands the frame first. This saves colour math, not SRAM: the
+  // indices live inside the pixels, which the CRGB modes need in full.
+  uint8_t* indexBuffer() { markWritten(); frame->indexed = true; return frame->indices(); }
+  CRGB* palette() { markDirty(); return frame->palette; }
+  void setPaletteWraps(bool wraps) { markDirty(); frame->paletteWraps = wraps; }
+#endif
 
   // Segment access
   void setSegmentPixel(uint8_t segment, uint16_t position, CRGB color);
   Segment getSegment(uint8_t segment) const;
+  SegmentSpan segmentSpan(uint8_t segment);
+
+  // Symmetric rendering: draw one segment, then fill the others from it.
+  // A few operations per pixel instead of the animation's full per-pixel math.
+  void replicateSegment(uint8_t source, uint8_t target, const SegmentTransform& transform);
 
   // Fill operations
   void fill(CRGB color);
@@ -48,8 +162,55 @@ public:
   static CRGB heatColor(uint8_t temperature);
 
 private:
-  CRGB leds[NUM_LEDS];
+  FrameBuffer shown;   // Render buffer, sent by show()
+  FrameBuffer* frame;  // Where writes go: &shown outside renderInto()
   Segment segments[NUM_SEGMENTS];
+  uint8_t brightness;
+
+#if LED_PARALLEL_OUTPUT
+  ParallelLEDOutput output;
+#endif
+
+#if LED_INDEXED_FRAMEBUFFER
+  void expandIndexed();
+  void flushIndexed() { if (frame->indexed) expandIndexed(); }
+#else
+  void flushIndexed() {}
+#endif
+
+#if LED_SKIP_UNCHANGED_FRAMES
+  bool dirty;            // Written since the last show()
+  uint16_t shownHash;    // Of the last frame sent
+  unsigned long lastSendMillis;
+  uint32_t skippedFrames;
+
+  void markDirty() { dirty = true; }
+#else
+  void markDirty() {}
+#endif
+
+  // Every write path goes through here; CRGB writes also expand an
+  // indexed frame first
+  void markWritten() {
+    markDirty();
+#if LED_SKIP_UNCHANGED_FRAMES
+    frame->solid = false;
+#endif
+  }
+  void beginWrite() { markWritten(); flushIndexed(); }
+
+#if ENABLE_POWER_LIMIT
+  uint16_t requestedMilliamps;
+  uint16_t drawnMilliamps;
+  uint32_t limitedFrames;
+  uint32_t channelSum;   // Of the last frame scanned, before brightness
+
+  uint8_t limitBrightness();
+#endif
+
+#if LED_SKIP_UNCHANGED_FRAMES || ENABLE_POWER_LIMIT
+  uint16_t scanFrame();
+#endif
 
   void initializeSegments();
   uint16_t mapSegmentPosition(uint8_t segment, uint16_t position) const;
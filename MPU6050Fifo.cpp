@@ -0,0 +1,206 @@
+#include "MPU6050Fifo.h"
+
+#define MPU_ADDRESS 0x68
+
+// Register map (MPU-6000/6050 register map rev 4.2)
+#define REG_SMPLRT_DIV 0x19
+#define REG_CONFIG 0x1A
+#define REG_GYRO_CONFIG 0x1B
+#define REG_ACCEL_CONFIG 0x1C
+#define REG_FIFO_EN 0x23
+#define REG_INT_PIN_CFG 0x37
+#define REG_INT_ENABLE 0x38
+#define REG_TEMP_OUT_H 0x41
+#define REG_USER_CTRL 0x6A
+#define REG_PWR_MGMT_1 0x6B
+#define REG_FIFO_COUNT_H 0x72
+#define REG_FIFO_R_W 0x74
+#define REG_WHO_AM_I 0x75
+
+#define FIFO_EN_ACCEL_GYRO 0x78   // XG, YG, ZG and accel into the FIFO
+#define USER_CTRL_FIFO_EN 0x40
+#define USER_CTRL_FIFO_RESET 0x04
+#define INT_DATA_RDY_EN 0x01
+#define GYRO_FS_500 0x08
+#define ACCEL_FS_8G 0x10
+#define CLOCK_PLL_XGYRO 0x01
+#define DEVICE_RESET 0x80
+
+#define FIFO_SAMPLE_BYTES 12      // Accel XYZ then gyro XYZ, big-endian int16
+#define FIFO_SIZE 1024
+
+// Whole samples per requestFrom(); AVR Wire buffers 32 bytes, so 2
+#ifdef BUFFER_LENGTH
+#define FIFO_BURST_SAMPLES (BUFFER_LENGTH / FIFO_SAMPLE_BYTES)
+#else
+#define FIFO_BURST_SAMPLES (32 / FIFO_SAMPLE_BYTES)
+#endif
+static_assert(FIFO_BURST_SAMPLES >= 1, "Wire's buffer must hold one FIFO sample");
+
+static volatile bool dataReady = true;
+
+MPU6050Fifo::MPU6050Fifo()
+  : head(0), tail(0), busErrors(0), overflows(0), droppedSamples(0) {
+}
+
+void MPU6050Fifo::onDataReady() {
+  dataReady = true;
+}
+
+bool MPU6050Fifo::begin() {
+  Wire.begin();
+  Wire.setClock(I2C_CLOCK_HZ);
+  Wire.setWireTimeout(I2C_TIMEOUT_US, true);  // Reset the TWI hardware on timeout
+
+  uint8_t whoAmI = 0;
+  if (!readRegisters(REG_WHO_AM_I, &whoAmI, 1) || whoAmI != MPU_ADDRESS) {
+    return false;
+  }
+
+  writeRegister(REG_PWR_MGMT_1, DEVICE_RESET);
+  delay(100);
+  writeRegister(REG_PWR_MGMT_1, CLOCK_PLL_XGYRO);
+
+  // 1 kHz internal rate with the DLPF on, divided down to MPU_FIFO_SAMPLE_RATE
+  writeRegister(REG_CONFIG, MPU_FIFO_DLPF_CFG);
+  writeRegister(REG_SMPLRT_DIV, 1000 / MPU_FIFO_SAMPLE_RATE - 1);
+  writeRegister(REG_GYRO_CONFIG, GYRO_FS_500);
+  writeRegister(REG_ACCEL_CONFIG, ACCEL_FS_8G);
+
+  // INT: active high, push-pull, 50 us pulse per sample
+  writeRegister(REG_INT_PIN_CFG, 0x00);
+  writeRegister(REG_INT_ENABLE, INT_DATA_RDY_EN);
+  resetFifo();
+
+#if MPU_INT_PIN >= 0
+  pinMode(MPU_INT_PIN, INPUT);
+  attachInterrupt(digitalPinToInterrupt(MPU_INT_PIN), onDataReady, RISING);
+#endif
+
+  return checkBus();
+}
+
+uint8_t MPU6050Fifo::poll() {
+#if MPU_INT_PIN >= 0
+  // Nothing new since the last drain
+  if (!dataReady) return 0;
+#endif
+  dataReady = false;
+
+  uint8_t countBytes[2];
+  if (!readRegisters(REG_FIFO_COUNT_H, countBytes, 2)) return 0;
+  uint16_t count = ((uint16_t)countBytes[0] << 8) | countBytes[1];
+
+  // An overflowed FIFO has lost its frame alignment; start over
+  if (count > FIFO_SIZE - FIFO_SAMPLE_BYTES) {
+    overflows++;
+    resetFifo();
+    return 0;
+  }
+
+  uint8_t samples = count / FIFO_SAMPLE_BYTES;
+  if (samples > MPU_FIFO_MAX_SAMPLES_PER_POLL) {
+    samples = MPU_FIFO_MAX_SAMPLES_PER_POLL;
+    dataReady = true;  // Come back for the rest next poll
+  }
+
+  // As many whole samples per transaction as Wire can buffer, so the
+  // address and register setup is paid once per burst, not per sample
+  uint8_t samplesRead = 0;
+  while (samplesRead < samples) {
+    uint8_t burst = samples - samplesRead;
+    if (burst > FIFO_BURST_SAMPLES) burst = FIFO_BURST_SAMPLES;
+
+    uint8_t raw[FIFO_BURST_SAMPLES * FIFO_SAMPLE_BYTES];
+    if (!readRegisters(REG_FIFO_R_W, raw, burst * FIFO_SAMPLE_BYTES)) {
+      // Partial reads misalign the FIFO
+      resetFifo();
+      break;
+    }
+
+    const uint8_t* p = raw;
+    for (uint8_t i = 0; i < burst; i++, p += FIFO_SAMPLE_BYTES) {
+      if ((uint8_t)(head - tail) >= MPU_FIFO_RING_SIZE) {
+        tail++;  // Ring full: drop the oldest sample
+        droppedSamples++;
+      }
+
+      RawMotionSample& s = ring[head & (MPU_FIFO_RING_SIZE - 1)];
+      s.accelX = (int16_t)((p[0] << 8) | p[1]);
+      s.accelY = (int16_t)((p[2] << 8) | p[3]);
+      s.accelZ = (int16_t)((p[4] << 8) | p[5]);
+      s.gyroX = (int16_t)((p[6] << 8) | p[7]);
+      s.gyroY = (int16_t)((p[8] << 8) | p[9]);
+      s.gyroZ = (int16_t)((p[10] << 8) | p[11]);
+      head++;
+    }
+    samplesRead += burst;
+  }
+
+  return samplesRead;
+}
+
+bool MPU6050Fifo::read(RawMotionSample& sample) {
+  if (head == tail) return false;
+
+  sample = ring[tail & (MPU_FIFO_RING_SIZE - 1)];
+  tail++;
+  return true;
+}
+
+float MPU6050Fifo::readTemperature() {
+  uint8_t raw[2];
+  if (!readRegisters(REG_TEMP_OUT_H, raw, 2)) return NAN;
+
+  int16_t value = (int16_t)((raw[0] << 8) | raw[1]);
+  return value / 340.0 + 36.53;
+}
+
+void MPU6050Fifo::resetFifo() {
+  writeRegister(REG_FIFO_EN, 0);
+  writeRegister(REG_USER_CTRL, USER_CTRL_FIFO_RESET);
+  writeRegister(REG_USER_CTRL, USER_CTRL_FIFO_EN);
+  writeRegister(REG_FIFO_EN, FIFO_EN_ACCEL_GYRO);
+}
+
+bool MPU6050Fifo::writeRegister(uint8_t reg, uint8_t value) {
+  Wire.beginTransmission(MPU_ADDRESS);
+  Wire.write(reg);
+  Wire.write(value);
+  if (Wire.endTransmission() != 0) {
+    busErrors++;
+    checkBus();
+    return false;
+  }
+  return true;
+}
+
+bool MPU6050Fifo::readRegisters(uint8_t reg, uint8_t* buffer, uint8_t length) {
+  Wire.beginTransmission(MPU_ADDRESS);
+  Wire.write(reg);
+  if (Wire.endTransmission(false) != 0) {
+    busErrors++;
+    checkBus();
+    return false;
+  }
+
+  if (Wire.requestFrom((uint8_t)MPU_ADDRESS, length) != length) {
+    busErrors++;
+    checkBus();
+    return false;
+  }
+
+  for (uint8_t i = 0; i < length; i++) {
+    buffer[i] = Wire.read();
+  }
+  return true;
+}
+
+// Clears a latched Wire timeout; false if one happened
+bool MPU6050Fifo::checkBus() {
+  if (Wire.getWireTimeoutFlag()) {
+    Wire.clearWireTimeoutFlag();
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,60 @@
+#ifndef MPU6050_FIFO_H
+#define MPU6050_FIFO_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "Config.h"
+#include "MotionSample.h"
+
+// Raw register driver for the MPU6050 that samples into the chip's FIFO
+// and burst-reads int16 accel/gyro frames at 400 kHz, as many whole
+// samples per I2C transaction as Wire's buffer holds (2 on AVR).
+//
+// The data-ready interrupt (MPU INT -> MPU_INT_PIN) only raises a flag;
+// the I2C work happens in poll(), which reads at most
+// MPU_FIFO_MAX_SAMPLES_PER_POLL samples and relies on Wire's timeout so a
+// stuck bus costs at most I2C_TIMEOUT_US per transaction.
+
+#define MPU_FIFO_SAMPLE_US (1000000UL / MPU_FIFO_SAMPLE_RATE)
+#define MPU_FIFO_RING_SIZE 16          // Power of two
+#define MPU_FIFO_MAX_SAMPLES_PER_POLL 8
+
+class MPU6050Fifo {
+public:
+  MPU6050Fifo();
+
+  bool begin();
+
+  // Move pending FIFO samples into the ring buffer. Returns samples read.
+  uint8_t poll();
+
+  // Ring buffer access
+  uint8_t available() const { return (uint8_t)(head - tail); }
+  bool read(RawMotionSample& sample);
+
+  // Die temperature in degrees C (separate register read)
+  float readTemperature();
+
+  // Health counters
+  uint16_t getBusErrors() const { return busErrors; }
+  uint16_t getOverflows() const { return overflows; }
+  uint16_t getDroppedSamples() const { return droppedSamples; }
+
+private:
+  RawMotionSample ring[MPU_FIFO_RING_SIZE];
+  uint8_t head;  // Free-running; written by poll()
+  uint8_t tail;  // Free-running; advanced by read()
+
+  uint16_t busErrors;
+  uint16_t overflows;
+  uint16_t droppedSamples;
+
+  bool writeRegister(uint8_t reg, uint8_t value);
+  bool readRegisters(uint8_t reg, uint8_t* buffer, uint8_t length);
+  bool checkBus();
+  void resetFifo();
+
+  static void onDataReady();
+};
+
+#endif
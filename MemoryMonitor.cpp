@@ -0,0 +1,154 @@
+#include "MemoryMonitor.h"
+#include "LEDController.h"
+#include "Animations.h"
+#include "AnimationRegistry.h"
+#include "MotionProcessor.h"
+#include "FrameProfiler.h"
+#include "Telemetry.h"
+#include "Scheduler.h"
+#include "QualityGovernor.h"
+
+// Static footprint of the objects kaleidoscope.ino declares; 0 for the
+// ones its configuration leaves out
+static constexpr uint16_t LEDS_BYTES = sizeof(LEDController);
+static constexpr uint16_t ANIMATIONS_BYTES = sizeof(Animations);
+static constexpr uint16_t MOTION_BYTES = sizeof(MotionProcessor);
+#if ENABLE_FRAME_PROFILER
+static constexpr uint16_t PROFILER_BYTES = sizeof(FrameProfiler);
+#else
+static constexpr uint16_t PROFILER_BYTES = 0;
+#endif
+#if ENABLE_BINARY_TELEMETRY
+static constexpr uint16_t TELEMETRY_BYTES = sizeof(Telemetry);
+#else
+static constexpr uint16_t TELEMETRY_BYTES = 0;
+#endif
+static constexpr uint16_t SCHEDULER_BYTES = sizeof(Scheduler);
+#if ENABLE_QUALITY_GOVERNOR
+static constexpr uint16_t GOVERNOR_BYTES = sizeof(QualityGovernor);
+#else
+static constexpr uint16_t GOVERNOR_BYTES = 0;
+#endif
+
+static constexpr bool fits(uint32_t bytes, uint32_t budget) {
+  return bytes <= budget * MEMORY_BUDGET_SCALE;
+}
+
+static_assert(fits(LEDS_BYTES, MEMORY_BUDGET_LEDS), "LEDController is over MEMORY_BUDGET_LEDS");
+static_assert(fits(ANIMATIONS_BYTES, MEMORY_BUDGET_ANIMATIONS), "Animations is over MEMORY_BUDGET_ANIMATIONS");
+static_assert(fits(MOTION_BYTES, MEMORY_BUDGET_MOTION), "MotionProcessor is over MEMORY_BUDGET_MOTION");
+static_assert(fits(PROFILER_BYTES, MEMORY_BUDGET_PROFILER), "FrameProfiler is over MEMORY_BUDGET_PROFILER");
+static_assert(fits(TELEMETRY_BYTES, MEMORY_BUDGET_TELEMETRY), "Telemetry is over MEMORY_BUDGET_TELEMETRY");
+static_assert(fits(SCHEDULER_BYTES, MEMORY_BUDGET_SCHEDULER), "Scheduler is over MEMORY_BUDGET_SCHEDULER");
+static_assert(fits(GOVERNOR_BYTES, MEMORY_BUDGET_GOVERNOR), "QualityGovernor is over MEMORY_BUDGET_GOVERNOR");
+
+// The arena is sized inside AnimationRegistry.cpp and checked there, so
+// the total counts its budget
+static_assert(fits((uint32_t)LEDS_BYTES + ANIMATIONS_BYTES + MEMORY_BUDGET_ARENA + MOTION_BYTES +
+                   PROFILER_BYTES + TELEMETRY_BYTES + SCHEDULER_BYTES + GOVERNOR_BYTES,
+                   MEMORY_STATIC_BUDGET),
+              "Static allocations leave less than MEMORY_STACK_RESERVE + MEMORY_CORE_RESERVE of SRAM");
+
+#if defined(__AVR__)
+extern uint8_t __heap_start;
+extern uint8_t* __brkval;
+
+static const uint8_t* heapEnd() {
+  return __brkval ? __brkval : &__heap_start;
+}
+
+#if ENABLE_MEMORY_MONITOR
+// Runs from .init3: the stack pointer and zero register are set up, .data
+// and .bss not yet, and nothing has been pushed. Naked, so it has no
+// prologue or return and falls through to .init4.
+void paintStack() __attribute__((naked, used, section(".init3")));
+
+void paintStack() {
+  uint8_t* p = &__heap_start;
+  uint8_t* top = (uint8_t*)SP;
+  while (p <= top) *p++ = MEMORY_PAINT;
+}
+#endif
+#endif
+
+uint16_t MemoryMonitor::freeRam() {
+#if defined(__AVR__)
+  char top;
+  return &top - (const char*)heapEnd();
+#else
+  return 0;
+#endif
+}
+
+uint16_t MemoryMonitor::stackMargin() {
+#if defined(__AVR__) && ENABLE_MEMORY_MONITOR
+  const uint8_t* p = heapEnd();
+  const uint8_t* top = (const uint8_t*)SP;
+  uint16_t margin = 0;
+  while (p < top && *p == MEMORY_PAINT) {
+    p++;
+    margin++;
+  }
+  return margin;
+#else
+  return 0;
+#endif
+}
+
+uint16_t MemoryMonitor::stackPeak() {
+#if defined(__AVR__) && ENABLE_MEMORY_MONITOR
+  return RAMEND + 1 - ((uint16_t)heapEnd() + stackMargin());
+#else
+  return 0;
+#endif
+}
+
+uint16_t MemoryMonitor::staticBytes() {
+#if defined(__AVR__)
+  return (uint16_t)&__heap_start - RAMSTART;
+#else
+  return 0;
+#endif
+}
+
+uint16_t MemoryMonitor::subsystemBytes(uint8_t subsystem) {
+  switch (subsystem) {
+    case MEMORY_LEDS: return LEDS_BYTES;
+    case MEMORY_ANIMATIONS: return ANIMATIONS_BYTES;
+    case MEMORY_ARENA: return AnimationRegistry::arenaSize() + sizeof(AnimationRegistry);
+    case MEMORY_MOTION: return MOTION_BYTES;
+    case MEMORY_PROFILER: return PROFILER_BYTES;
+    case MEMORY_TELEMETRY: return TELEMETRY_BYTES;
+    case MEMORY_SCHEDULER: return SCHEDULER_BYTES;
+    case MEMORY_GOVERNOR: return GOVERNOR_BYTES;
+    default: return 0;
+  }
+}
+
+uint16_t MemoryMonitor::subsystemBudget(uint8_t subsystem) {
+  switch (subsystem) {
+    case MEMORY_LEDS: return MEMORY_BUDGET_LEDS;
+    case MEMORY_ANIMATIONS: return MEMORY_BUDGET_ANIMATIONS;
+    case MEMORY_ARENA: return MEMORY_BUDGET_ARENA;
+    case MEMORY_MOTION: return MEMORY_BUDGET_MOTION;
+    case MEMORY_PROFILER: return MEMORY_BUDGET_PROFILER;
+    case MEMORY_TELEMETRY: return MEMORY_BUDGET_TELEMETRY;
+    case MEMORY_SCHEDULER: return MEMORY_BUDGET_SCHEDULER;
+    case MEMORY_GOVERNOR: return MEMORY_BUDGET_GOVERNOR;
+    default: return 0;
+  }
+}
+
+const char* MemoryMonitor::subsystemName(uint8_t subsystem) {
+  switch (subsystem) {
+    case MEMORY_LEDS: return "leds";
+    case MEMORY_ANIMATIONS: return "animations";
+    case MEMORY_ARENA: return "arena";
+    case MEMORY_MOTION: return "motion";
+    case MEMORY_PROFILER: return "profiler";
+    case MEMORY_TELEMETRY: return "telemetry";
+    case MEMORY_SCHEDULER: return "scheduler";
+    case MEMORY_GOVERNOR: return "governor";
+    default: return "?";
+  }
+}
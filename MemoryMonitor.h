@@ -0,0 +1,81 @@
+#ifndef MEMORY_MONITOR_H
+#define MEMORY_MONITOR_H
+
+#include <Arduino.h>
+#include "Config.h"
+
+// SRAM accounting (ENABLE_MEMORY_MONITOR for the runtime half).
+//
+// Compile time: each subsystem's static footprint is checked against its
+// budget below, and their sum against what the Mega's 8 KB leaves after
+// the stack and core reserves, so a change that would crowd out the stack
+// fails the build (MemoryMonitor.cpp). The host build checks the same
+// budgets with MEMORY_BUDGET_SCALE times the room, since its ints, longs
+// and pointers are wider.
+//
+// Run time: a startup hook in .init3 fills everything between the end of
+// .bss and the top of RAM with MEMORY_PAINT before any constructor runs.
+// The stack overwrites the paint as it grows, so the first touched byte
+// above the heap marks the deepest the stack has ever been. stackMargin()
+// scans up from the heap to that byte (about 5 cycles per byte, so ~1 ms
+// per 3 KB; call it from a slow task). That is the worst case seen, which
+// matters more than freeRam() at the moment it is read.
+//
+// On the host the probes return 0.
+
+#define MEMORY_SRAM_BYTES 8192      // ATmega2560
+#define MEMORY_STACK_RESERVE 1024   // Deepest expected call chain plus interrupts
+#define MEMORY_CORE_RESERVE 1024    // Serial/Wire buffers, FastLED, Adafruit heap objects
+#define MEMORY_STATIC_BUDGET (MEMORY_SRAM_BYTES - MEMORY_STACK_RESERVE - MEMORY_CORE_RESERVE)
+#define MEMORY_STACK_WARN_BYTES 256 // Status prints a warning below this margin
+#define MEMORY_PAINT 0xC5
+
+// Per-subsystem budgets (AVR bytes)
+#define MEMORY_BUDGET_LEDS (NUM_LEDS * 3 + 160 + LED_PARALLEL_OUTPUT * 32)
+#define MEMORY_BUDGET_ANIMATIONS (NUM_LEDS * 3 + 96)
+#define MEMORY_BUDGET_ARENA (NUM_LEDS + 64)   // Mode state arena plus the registry
+#define MEMORY_BUDGET_MOTION 1536
+#define MEMORY_BUDGET_PROFILER 640
+#define MEMORY_BUDGET_TELEMETRY (TELEMETRY_RING_SIZE + 8)
+#define MEMORY_BUDGET_SCHEDULER 200
+#define MEMORY_BUDGET_GOVERNOR 48
+
+#if defined(__AVR__)
+#define MEMORY_BUDGET_SCALE 1
+#else
+#define MEMORY_BUDGET_SCALE 2
+#endif
+
+enum MemorySubsystem : uint8_t {
+  MEMORY_LEDS,
+  MEMORY_ANIMATIONS,
+  MEMORY_ARENA,
+  MEMORY_MOTION,
+  MEMORY_PROFILER,
+  MEMORY_TELEMETRY,
+  MEMORY_SCHEDULER,
+  MEMORY_GOVERNOR,
+  MEMORY_SUBSYSTEMS
+};
+
+class MemoryMonitor {
+public:
+  // Bytes between the heap and the stack right now
+  static uint16_t freeRam();
+
+  // Painted bytes the stack has never reached: the smallest free RAM seen
+  static uint16_t stackMargin();
+
+  // Deepest stack use since reset, in bytes below the top of RAM
+  static uint16_t stackPeak();
+
+  // .data + .bss
+  static uint16_t staticBytes();
+
+  // Static footprint of one subsystem (0 if compiled out) and its budget
+  static uint16_t subsystemBytes(uint8_t subsystem);
+  static uint16_t subsystemBudget(uint8_t subsystem);
+  static const char* subsystemName(uint8_t subsystem);
+};
+
+#endif
@@ -1,10 +1,37 @@
 #include "MotionProcessor.h"
 #include <Arduino.h>
+#include <EEPROM.h>
+#include <math.h>
+#include <stddef.h>
+
+// Sensor units to the SI units MotionData has always used
+#define ACCEL_MS2_PER_LSB (9.81 / MPU_ACCEL_LSB_PER_G)
+#define GYRO_RAD_PER_LSB ((10.0 * PI / 180.0) / MPU_GYRO_LSB_PER_DPS_X10)
+
+#define CALIBRATION_MAGIC 0x4B31  // "K1"; bump when StoredCalibration changes
 
 MotionProcessor::MotionProcessor()
-  : calibrated(false),
-    accelXOffset(0), accelYOffset(0), accelZOffset(0),
-    prevTilt(0), prevRotation(0), prevShake(0) {
+  : lastSampleMicros(0),
+    batchSpanMicros(0),
+    historyHead(0), historyCount(0),
+    displayLeadMicros(0),
+    calibrated(false),
+    calibrationState(CAL_IDLE),
+    calibrationCount(0),
+    pendingCalibrationByte(sizeof(StoredCalibration)),
+    prevRotation(0), prevShake(0) {
+  memset(&offsets, 0, sizeof(offsets));
+  memset(&savedGyroOffsets, 0, sizeof(savedGyroOffsets));
+  memset(&previousGyro, 0, sizeof(previousGyro));
+  motionData.lastGesture = GESTURE_NONE;
+  motionData.gestureMillis = 0;
+  motionData.motionFrequency = 0;
+  motionData.motionRhythm = 0;
+  memset(motionData.motionBands, 0, sizeof(motionData.motionBands));
+  resetLatencyStats();
+#if MPU_USE_FIFO
+  temperatureCountdown = 0;
+#endif
 }
 
 bool MotionProcessor::begin() {
@@ -15,82 +42,481 @@ bool MotionProcessor::begin() {
 
   Serial.println("MPU6050 Found!");
 
+#if MPU_USE_FIFO
+  // Ranges, DLPF and sample rate are set by the FIFO driver (+-8 G, +-500 deg/s)
+  Serial.print("FIFO sampling at ");
+  Serial.print(MPU_FIFO_SAMPLE_RATE);
+  Serial.println(" Hz");
+#else
+
   // Set accelerometer range to ±8G
   mpu.setAccelerometerRange(MPU6050_RANGE_8_G);
 
   // Set gyro range to ±500 deg/s
   mpu.setGyroRange(MPU6050_RANGE_500_DEG);
 
-  // Set filter bandwidth to 21 Hz
-  mpu.setFilterBandwidth(MPU6050_BAND_21_HZ);
+  // Set filter bandwidth to 44 Hz; the orientation filter handles the
+  // noise, so keep the DLPF's group delay short
+  mpu.setFilterBandwidth(MPU6050_BAND_44_HZ);
+#endif
+  lastSampleMicros = micros();
+  return true;
+}
+
+void MotionProcessor::startCalibration() {
+  Serial.println("Calibrating MPU6050 (keep device still and level)...");
+  calibrationState = CAL_FULL;
+  calibrationCount = 0;
+}
+
+bool MotionProcessor::loadCalibration() {
+  StoredCalibration stored;
+  EEPROM.get(CALIBRATION_EEPROM_ADDR, stored);
+  if (stored.magic != CALIBRATION_MAGIC ||
+      stored.checksum != calibrationChecksum(stored)) {
+    Serial.println("No stored calibration");
+    return false;
+  }
 
-  delay(100);
+  // Gyro bias drifts with temperature; only trust offsets taken nearby
+#if MPU_USE_FIFO
+  float temperature = mpu.readTemperature();
+#else
+  sensors_event_t a, g, temp;
+  mpu.getEvent(&a, &g, &temp);
+  float temperature = temp.temperature;
+#endif
+  if (!(abs(temperature - stored.tempCenti / 100.0) <= CALIBRATION_TEMP_TOLERANCE)) {
+    Serial.println("Stored calibration is from a different temperature");
+    return false;
+  }
+
+  offsets = stored.offsets;
+  savedGyroOffsets = stored.offsets;
+  calibrated = true;
+  Serial.println("Loaded stored calibration");
   return true;
 }
 
-void MotionProcessor::calibrate() {
-  Serial.println("Calibrating MPU6050...");
-  Serial.println("Keep device still!");
+bool MotionProcessor::isStill(const RawMotionSample& average) const {
+  // Rate change between updates does not depend on the (unknown) bias
+  const int16_t maxDelta = STILL_GYRO_THRESHOLD * MPU_GYRO_LSB_PER_DPS_X10 / 10;
+  if (abs(average.gyroX - previousGyro.gyroX) > maxDelta ||
+      abs(average.gyroY - previousGyro.gyroY) > maxDelta ||
+      abs(average.gyroZ - previousGyro.gyroZ) > maxDelta) {
+    return false;
+  }
 
-  float sumX = 0, sumY = 0, sumZ = 0;
+  // Once calibrated, also reject a steady rotation (turntable, slow pan)
+  if (calibrated && (abs(average.gyroX) > maxDelta ||
+                     abs(average.gyroY) > maxDelta ||
+                     abs(average.gyroZ) > maxDelta)) {
+    return false;
+  }
 
-  for (int i = 0; i < CALIBRATION_SAMPLES; i++) {
-    sensors_event_t a, g, temp;
-    mpu.getEvent(&a, &g, &temp);
+  int32_t ax = average.accelX, ay = average.accelY, az = average.accelZ;
+  uint32_t magnitudeSq = (uint32_t)(ax * ax) + (uint32_t)(ay * ay) + (uint32_t)(az * az);
+  float magnitude = sqrt((float)magnitudeSq) / MPU_ACCEL_LSB_PER_G;
+  return abs(magnitude - 1.0) <= STILL_ACCEL_TOLERANCE;
+}
 
-    sumX += a.acceleration.x;
-    sumY += a.acceleration.y;
-    sumZ += a.acceleration.z;
+// Accumulate still updates; a full run measures accel and gyro offsets
+// (device level), a background run only the gyro bias (any orientation)
+void MotionProcessor::updateCalibration(const RawMotionSample& average) {
+  bool still = isStill(average);
+  previousGyro = average;
 
-    delay(10);
+  if (calibrationState == CAL_IDLE) {
+#if BACKGROUND_RECALIBRATION
+    if (!calibrated || !still) return;
+    calibrationState = CAL_BACKGROUND;
+    calibrationCount = 0;
+#else
+    return;
+#endif
   }
 
-  accelXOffset = sumX / CALIBRATION_SAMPLES;
-  accelYOffset = sumY / CALIBRATION_SAMPLES;
-  accelZOffset = (sumZ / CALIBRATION_SAMPLES) - 9.81; // Subtract gravity
+  if (!still) {
+    // Motion spoils the window; full calibration waits for the next still spell
+    calibrationCount = 0;
+    if (calibrationState == CAL_BACKGROUND) calibrationState = CAL_IDLE;
+    return;
+  }
+
+  if (calibrationCount == 0) {
+    memset(calibrationSums, 0, sizeof(calibrationSums));
+  }
 
+  // Sums of uncalibrated readings
+  calibrationSums[0] += (int32_t)average.accelX + offsets.accelX;
+  calibrationSums[1] += (int32_t)average.accelY + offsets.accelY;
+  calibrationSums[2] += (int32_t)average.accelZ + offsets.accelZ;
+  calibrationSums[3] += (int32_t)average.gyroX + offsets.gyroX;
+  calibrationSums[4] += (int32_t)average.gyroY + offsets.gyroY;
+  calibrationSums[5] += (int32_t)average.gyroZ + offsets.gyroZ;
+  calibrationCount++;
+
+  if (calibrationCount >= CALIBRATION_SAMPLES) {
+    finishCalibration();
+  }
+}
+
+void MotionProcessor::finishCalibration() {
+  bool full = calibrationState == CAL_FULL;
+  calibrationState = CAL_IDLE;
+
+  if (full) {
+    offsets.accelX = calibrationSums[0] / calibrationCount;
+    offsets.accelY = calibrationSums[1] / calibrationCount;
+    offsets.accelZ = calibrationSums[2] / calibrationCount - MPU_ACCEL_LSB_PER_G; // Subtract gravity
+  }
+  offsets.gyroX = calibrationSums[3] / calibrationCount;
+  offsets.gyroY = calibrationSums[4] / calibrationCount;
+  offsets.gyroZ = calibrationSums[5] / calibrationCount;
+  calibrationCount = 0;
   calibrated = true;
-  Serial.println("Calibration complete!");
-  Serial.print("Offsets: X=");
-  Serial.print(accelXOffset);
-  Serial.print(" Y=");
-  Serial.print(accelYOffset);
-  Serial.print(" Z=");
-  Serial.println(accelZOffset);
+
+  if (full) {
+    // Re-seed from level, bias-free readings
+    orientation.reset();
+
+    Serial.println("Calibration complete!");
+    Serial.print("Offsets: X=");
+    Serial.print(offsets.accelX * ACCEL_MS2_PER_LSB);
+    Serial.print(" Y=");
+    Serial.print(offsets.accelY * ACCEL_MS2_PER_LSB);
+    Serial.print(" Z=");
+    Serial.println(offsets.accelZ * ACCEL_MS2_PER_LSB);
+  }
+
+  // Background runs only touch EEPROM when the bias really moved, to
+  // spare its ~100k write cycles
+  if (full ||
+      abs(offsets.gyroX - savedGyroOffsets.gyroX) > CALIBRATION_SAVE_DELTA ||
+      abs(offsets.gyroY - savedGyroOffsets.gyroY) > CALIBRATION_SAVE_DELTA ||
+      abs(offsets.gyroZ - savedGyroOffsets.gyroZ) > CALIBRATION_SAVE_DELTA) {
+    saveCalibration();
+  }
+}
+
+void MotionProcessor::saveCalibration() {
+  // A failed temperature read is NaN, which has no tempCenti; keep what
+  // EEPROM holds and let a later run save
+  if (!isfinite(motionData.temp)) return;
+
+  pendingCalibration.magic = CALIBRATION_MAGIC;
+  pendingCalibration.offsets = offsets;
+  pendingCalibration.tempCenti = motionData.temp * 100;
+  pendingCalibration.checksum = calibrationChecksum(pendingCalibration);
+  pendingCalibrationByte = 0;  // Restarts a save still in progress
+  savedGyroOffsets = offsets;
+}
+
+// An EEPROM byte takes ~3.3 ms to write and EEPROM.put() waits out each
+// one, ~50 ms for a whole record. Instead each update starts at most one
+// write, once the previous has finished, and skips bytes that already
+// match. The checksum is the last byte, so a record cut short by a reset
+// fails loadCalibration() rather than loading half-written offsets.
+void MotionProcessor::writePendingCalibration() {
+  if (pendingCalibrationByte >= sizeof(StoredCalibration) || !eeprom_is_ready()) return;
+
+  const uint8_t* bytes = (const uint8_t*)&pendingCalibration;
+  while (pendingCalibrationByte < sizeof(StoredCalibration)) {
+    uint8_t i = pendingCalibrationByte++;
+    if (EEPROM.read(CALIBRATION_EEPROM_ADDR + i) != bytes[i]) {
+      EEPROM.write(CALIBRATION_EEPROM_ADDR + i, bytes[i]);
+      return;
+    }
+  }
+}
+
+uint8_t MotionProcessor::calibrationChecksum(const StoredCalibration& stored) {
+  const uint8_t* bytes = (const uint8_t*)&stored;
+  uint8_t sum = 0;
+  for (uint8_t i = 0; i < offsetof(StoredCalibration, checksum); i++) {
+    sum += bytes[i];
+  }
+  return ~sum;
 }
 
 bool MotionProcessor::update() {
-  sensors_event_t a, g, temp;
-  mpu.getEvent(&a, &g, &temp);
+  writePendingCalibration();
 
-  // Store raw data with calibration offsets
-  motionData.accelX = a.acceleration.x - accelXOffset;
-  motionData.accelY = a.acceleration.y - accelYOffset;
-  motionData.accelZ = a.acceleration.z - accelZOffset;
+  RawMotionSample average;
+  if (!readSensor(average)) {
+    return false;
+  }
 
-  motionData.gyroX = g.gyro.x;
-  motionData.gyroY = g.gyro.y;
-  motionData.gyroZ = g.gyro.z;
+  motionData.accelX = average.accelX * ACCEL_MS2_PER_LSB;
+  motionData.accelY = average.accelY * ACCEL_MS2_PER_LSB;
+  motionData.accelZ = average.accelZ * ACCEL_MS2_PER_LSB;
 
-  motionData.temp = temp.temperature;
+  motionData.gyroX = average.gyroX * GYRO_RAD_PER_LSB;
+  motionData.gyroY = average.gyroY * GYRO_RAD_PER_LSB;
+  motionData.gyroZ = average.gyroZ * GYRO_RAD_PER_LSB;
 
   // Calculate orientation and motion characteristics
   calculateOrientation();
   calculateMotionCharacteristics();
+#if ENABLE_GESTURES
+  gestures.addUpdate(motionData.shakeIntensity, motionData.tiltAngle);
+  motionData.lastGesture = gestures.last().type;
+  motionData.gestureMillis = gestures.last().millis;
+#endif
+#if ENABLE_MOTION_SPECTRUM
+  if (spectrum.add((int32_t)average.accelX * 1000 / MPU_ACCEL_LSB_PER_G,
+                   (int32_t)average.accelY * 1000 / MPU_ACCEL_LSB_PER_G)) {
+    motionData.motionFrequency = spectrum.dominantFrequency();
+    motionData.motionRhythm = spectrum.rhythm();
+    for (uint8_t bin = 0; bin < SPECTRUM_BINS; bin++) {
+      motionData.motionBands[bin] = spectrum.level(bin);
+    }
+  }
+#endif
   applySmoothing();
 
+  updateCalibration(average);
+
+  // Timestamp the batch at its midpoint, as measured rather than as read
+  historyHead = (historyHead + 1) & (MOTION_HISTORY_SIZE - 1);
+  if (historyCount < MOTION_HISTORY_SIZE) historyCount++;
+  history[historyHead].micros = micros() - MOTION_SENSOR_DELAY_US - batchSpanMicros / 2;
+  history[historyHead].data = motionData;
+
+  return true;
+}
+
+MotionData MotionProcessor::getMotionDataAt(unsigned long timeMicros) const {
+  if (historyCount == 0) return motionData;
+
+  const MotionSnapshot& newest = history[historyHead];
+  long ahead = (long)(timeMicros - newest.micros);
+  if (ahead >= 0 || historyCount == 1) {
+    MotionData predicted = newest.data;
+    if (ahead > MOTION_MAX_EXTRAPOLATION_US) ahead = MOTION_MAX_EXTRAPOLATION_US;
+    if (ahead > 0) extrapolate(predicted, ahead);
+    return predicted;
+  }
+
+  // Walk back to the pair of samples around timeMicros
+  for (uint8_t i = 1; i < historyCount; i++) {
+    const MotionSnapshot& newer = history[(historyHead - i + 1) & (MOTION_HISTORY_SIZE - 1)];
+    const MotionSnapshot& older = history[(historyHead - i) & (MOTION_HISTORY_SIZE - 1)];
+    if ((long)(timeMicros - older.micros) < 0) continue;
+
+    float t = (float)(timeMicros - older.micros) / (newer.micros - older.micros);
+    const MotionData& a = older.data;
+    const MotionData& b = newer.data;
+    MotionData out = b;
+
+    out.accelX = a.accelX + (b.accelX - a.accelX) * t;
+    out.accelY = a.accelY + (b.accelY - a.accelY) * t;
+    out.accelZ = a.accelZ + (b.accelZ - a.accelZ) * t;
+    out.gyroX = a.gyroX + (b.gyroX - a.gyroX) * t;
+    out.gyroY = a.gyroY + (b.gyroY - a.gyroY) * t;
+    out.gyroZ = a.gyroZ + (b.gyroZ - a.gyroZ) * t;
+
+    out.pitch = a.pitch + (b.pitch - a.pitch) * t;
+    out.roll = a.roll + (b.roll - a.roll) * t;
+
+    // Yaw takes the short way across +-180
+    float yawDelta = b.yaw - a.yaw;
+    if (yawDelta > 180.0) yawDelta -= 360.0;
+    if (yawDelta < -180.0) yawDelta += 360.0;
+    out.yaw = a.yaw + yawDelta * t;
+    if (out.yaw > 180.0) out.yaw -= 360.0;
+    if (out.yaw < -180.0) out.yaw += 360.0;
+    out.yawRate = a.yawRate + (b.yawRate - a.yawRate) * t;
+
+    out.tiltAngle = a.tiltAngle + (b.tiltAngle - a.tiltAngle) * t;
+    out.rotationSpeed = a.rotationSpeed + (b.rotationSpeed - a.rotationSpeed) * t;
+    out.shakeIntensity = a.shakeIntensity + (b.shakeIntensity - a.shakeIntensity) * t;
+    out.tiltNormalized = a.tiltNormalized + (b.tiltNormalized - a.tiltNormalized) * t;
+    out.rotationNormalized = a.rotationNormalized + (b.rotationNormalized - a.rotationNormalized) * t;
+    out.shakeNormalized = a.shakeNormalized + (b.shakeNormalized - a.shakeNormalized) * t;
+    return out;
+  }
+
+  // Older than anything kept
+  return history[(historyHead - historyCount + 1) & (MOTION_HISTORY_SIZE - 1)].data;
+}
+
+// Advance orientation along the sample's gyro rates; the rest is held
+void MotionProcessor::extrapolate(MotionData& data, unsigned long aheadMicros) const {
+  float seconds = aheadMicros * 1e-6;
+
+  data.pitch = constrain(data.pitch + data.gyroX * (180.0 / PI) * seconds, -90.0, 90.0);
+  data.roll += data.gyroY * (180.0 / PI) * seconds;
+  if (data.roll > 180.0) data.roll -= 360.0;
+  if (data.roll < -180.0) data.roll += 360.0;
+
+  data.yaw += data.yawRate * seconds;
+  if (data.yaw > 180.0) data.yaw -= 360.0;
+  if (data.yaw < -180.0) data.yaw += 360.0;
+
+  data.tiltAngle = sqrt(data.pitch * data.pitch + data.roll * data.roll);
+  data.tiltNormalized = mapToNormalized(data.tiltAngle, TILT_THRESHOLD, 90.0);
+}
+
+void MotionProcessor::recordFrameDisplayed(unsigned long frameStartMicros, unsigned long displayMicros) {
+  unsigned long predicted = predictDisplayMicros(frameStartMicros);
+  long error = (long)(displayMicros - predicted);
+
+  // Follow render + output time with a 1/8 EMA
+  displayLeadMicros += error / 8;
+
+  if (historyCount == 0) return;
+
+  uint32_t motionToPhoton = displayMicros - history[historyHead].micros;
+  if (motionToPhoton < latency.minUs) latency.minUs = motionToPhoton;
+  if (motionToPhoton > latency.maxUs) latency.maxUs = motionToPhoton;
+  latency.totalUs += motionToPhoton;
+  latency.predictionErrorTotalUs += error < 0 ? -error : error;
+  latency.frames++;
+
+  // Halve before the totals can overflow; keeps a recent-weighted average
+  if (latency.frames == 0x8000) {
+    latency.totalUs /= 2;
+    latency.predictionErrorTotalUs /= 2;
+    latency.frames /= 2;
+  }
+}
+
+void MotionProcessor::resetLatencyStats() {
+  latency.minUs = 0xFFFFFFFFUL;
+  latency.maxUs = 0;
+  latency.totalUs = 0;
+  latency.predictionErrorTotalUs = 0;
+  latency.frames = 0;
+}
+
+void MotionProcessor::printLatencyReport() const {
+  Serial.println("=== Motion-to-Photon (us: min/avg/max) ===");
+  if (latency.frames == 0) {
+    Serial.println("No frames recorded");
+    Serial.println();
+    return;
+  }
+
+  Serial.print("Latency: ");
+  Serial.print(latency.minUs);
+  Serial.print("/");
+  Serial.print(latency.totalUs / latency.frames);
+  Serial.print("/");
+  Serial.println(latency.maxUs);
+  Serial.print("Display lead: ");
+  Serial.print(displayLeadMicros);
+  Serial.print(" (prediction error avg ");
+  Serial.print(latency.predictionErrorTotalUs / latency.frames);
+  Serial.println(")");
+  Serial.print("Frames: ");
+  Serial.println(latency.frames);
+  Serial.println();
+}
+
+// Subtract calibration offsets and feed the gyro integrator
+void MotionProcessor::processSample(RawMotionSample& sample, uint16_t dtMicros) {
+  sample.accelX -= offsets.accelX;
+  sample.accelY -= offsets.accelY;
+  sample.accelZ -= offsets.accelZ;
+  sample.gyroX -= offsets.gyroX;
+  sample.gyroY -= offsets.gyroY;
+  sample.gyroZ -= offsets.gyroZ;
+
+  orientation.integrate(sample, dtMicros);
+#if ENABLE_GESTURES
+  gestures.addSample(sample, dtMicros);
+#endif
+}
+
+// Read everything sampled since the last call, run the orientation filter
+// on it and return the calibrated average in sensor units
+bool MotionProcessor::readSensor(RawMotionSample& average) {
+  int32_t sumAX = 0, sumAY = 0, sumAZ = 0;
+  int32_t sumGX = 0, sumGY = 0, sumGZ = 0;
+  uint8_t count = 0;
+  uint32_t batchMicros = 0;
+  RawMotionSample sample;
+
+#if MPU_USE_FIFO
+  mpu.poll();
+
+  // Every FIFO sample goes through the gyro integrator at the full sample
+  // rate; the average of the batch also filters out aliasing
+  while (mpu.read(sample)) {
+    processSample(sample, MPU_FIFO_SAMPLE_US);
+    batchMicros += MPU_FIFO_SAMPLE_US;
+    sumAX += sample.accelX;
+    sumAY += sample.accelY;
+    sumAZ += sample.accelZ;
+    sumGX += sample.gyroX;
+    sumGY += sample.gyroY;
+    sumGZ += sample.gyroZ;
+    count++;
+  }
+
+  if (count == 0) {
+    return false;
+  }
+  batchSpanMicros = batchMicros - MPU_FIFO_SAMPLE_US;  // First to last sample
+
+  // Temperature is not in the FIFO; refresh it about once a second
+  if (temperatureCountdown == 0) {
+    motionData.temp = mpu.readTemperature();
+    temperatureCountdown = MPU_UPDATE_RATE;
+  }
+  temperatureCountdown--;
+#else
+  sensors_event_t a, g, temp;
+  mpu.getEvent(&a, &g, &temp);
+
+  // Back to sensor units so both drivers share the integer pipeline
+  sample.accelX = constrain(a.acceleration.x / ACCEL_MS2_PER_LSB, -32768.0, 32767.0);
+  sample.accelY = constrain(a.acceleration.y / ACCEL_MS2_PER_LSB, -32768.0, 32767.0);
+  sample.accelZ = constrain(a.acceleration.z / ACCEL_MS2_PER_LSB, -32768.0, 32767.0);
+  sample.gyroX = constrain(g.gyro.x / GYRO_RAD_PER_LSB, -32768.0, 32767.0);
+  sample.gyroY = constrain(g.gyro.y / GYRO_RAD_PER_LSB, -32768.0, 32767.0);
+  sample.gyroZ = constrain(g.gyro.z / GYRO_RAD_PER_LSB, -32768.0, 32767.0);
+
+  unsigned long now = micros();
+  batchMicros = now - lastSampleMicros;
+  lastSampleMicros = now;
+  processSample(sample, batchMicros > 0xFFFF ? 0xFFFF : batchMicros);
+
+  sumAX = sample.accelX;
+  sumAY = sample.accelY;
+  sumAZ = sample.accelZ;
+  sumGX = sample.gyroX;
+  sumGY = sample.gyroY;
+  sumGZ = sample.gyroZ;
+  count = 1;
+  batchSpanMicros = 0;
+
+  motionData.temp = temp.temperature;
+#endif
+
+  average.accelX = sumAX / count;
+  average.accelY = sumAY / count;
+  average.accelZ = sumAZ / count;
+  average.gyroX = sumGX / count;
+  average.gyroY = sumGY / count;
+  average.gyroZ = sumGZ / count;
+
+  // Gravity correction once per batch, on the averaged (less noisy) accel
+  orientation.correct(average.accelX, average.accelY, average.accelZ,
+                      batchMicros > 0xFFFF ? 0xFFFF : batchMicros);
   return true;
 }
 
 void MotionProcessor::calculateOrientation() {
-  // Calculate pitch and roll from accelerometer
-  // Pitch (rotation around Y axis)
-  motionData.pitch = atan2(motionData.accelY,
-                           sqrt(motionData.accelX * motionData.accelX +
-                                motionData.accelZ * motionData.accelZ)) * 180.0 / PI;
+  // Pitch (forward/backward) and roll (left/right) from the fused filter,
+  // which follows the gyro immediately instead of lagging the accelerometer
+  motionData.pitch = orientation.getPitchDegrees();
+  motionData.roll = orientation.getRollDegrees();
 
-  // Roll (rotation around X axis)
-  motionData.roll = atan2(-motionData.accelX, motionData.accelZ) * 180.0 / PI;
+  // Pan around the vertical axis
+  motionData.yaw = orientation.getYawDegrees();
+  motionData.yawRate = motionData.gyroZ * 180.0 / PI;
 
   // Calculate total tilt angle
   motionData.tiltAngle = sqrt(motionData.pitch * motionData.pitch +
@@ -120,19 +546,18 @@ void MotionProcessor::calculateMotionCharacteristics() {
 }
 
 void MotionProcessor::applySmoothing() {
-  // Apply exponential moving average for smoothing
+  // Apply exponential moving average for smoothing. Tilt comes from the
+  // orientation filter, which is already smooth, so it is not delayed here.
   float alpha = MOTION_SMOOTHING;
 
-  motionData.tiltAngle = alpha * motionData.tiltAngle + (1 - alpha) * prevTilt;
   motionData.rotationSpeed = alpha * motionData.rotationSpeed + (1 - alpha) * prevRotation;
   motionData.shakeIntensity = alpha * motionData.shakeIntensity + (1 - alpha) * prevShake;
 
-  prevTilt = motionData.tiltAngle;
   prevRotation = motionData.rotationSpeed;
   prevShake = motionData.shakeIntensity;
 }
 
-float MotionProcessor::mapToNormalized(float value, float threshold, float maxValue) {
+float MotionProcessor::mapToNormalized(float value, float threshold, float maxValue) const {
   if (value < threshold) return 0.0;
   float normalized = (value - threshold) / (maxValue - threshold);
   return constrain(normalized, 0.0, 1.0);
@@ -1,10 +1,18 @@
 #ifndef MOTION_PROCESSOR_H
 #define MOTION_PROCESSOR_H
 
-#include <Adafruit_MPU6050.h>
-#include <Adafruit_Sensor.h>
 #include <Wire.h>
 #include "Config.h"
+#include "MotionSample.h"
+#include "OrientationFilter.h"
+#include "GestureDetector.h"
+#include "MotionSpectrum.h"
+#if MPU_USE_FIFO
+#include "MPU6050Fifo.h"
+#else
+#include <Adafruit_MPU6050.h>
+#include <Adafruit_Sensor.h>
+#endif
 
 struct MotionData {
   // Raw sensor data
@@ -12,9 +20,11 @@ struct MotionData {
   float gyroX, gyroY, gyroZ;     // Rotation in rad/s
   float temp;                     // Temperature in C
 
-  // Processed orientation data
+  // Processed orientation data (gyro/accel fused)
   float pitch;                    // Tilt forward/backward (degrees)
   float roll;                     // Tilt left/right (degrees)
+  float yaw;                      // Pan around the vertical axis (degrees, -180..180 relative to start)
+  float yawRate;                  // Pan speed (deg/s, signed)
 
   // Motion characteristics
   float tiltAngle;               // Total tilt from neutral (degrees)
@@ -25,6 +35,25 @@ struct MotionData {
   float tiltNormalized;          // 0 = neutral, 1 = max tilt
   float rotationNormalized;      // 0 = still, 1 = fast rotation
   float shakeNormalized;         // 0 = still, 1 = intense shake
+
+  // Newest gesture (GESTURE_NONE until the first) and its millis() time
+  GestureType lastGesture;
+  unsigned long gestureMillis;
+
+  // Sway/shake spectrum over the last completed block (see MotionSpectrum.h)
+  float motionFrequency;              // Dominant frequency (Hz), 0 if nothing stands out
+  float motionRhythm;                 // 0-1, share of the motion energy at that frequency
+  uint8_t motionBands[SPECTRUM_BINS]; // Amplitude per bin, 0-255
+};
+
+// Motion-to-photon timing, in microseconds. Latency runs from when the
+// newest sample was measured (DLPF delay included) to when the frame that
+// used it latched on the LEDs.
+struct MotionLatencyStats {
+  uint32_t minUs, maxUs;
+  uint32_t totalUs;
+  uint32_t predictionErrorTotalUs;  // |predicted - actual| display time
+  uint16_t frames;
 };
 
 class MotionProcessor {
@@ -33,9 +62,38 @@ public:
 
   bool begin();
   bool update();
-  void calibrate();
+
+  // Calibration runs in the background of update(): a full calibration
+  // (accel + gyro, device level) starts on request and completes after
+  // CALIBRATION_SAMPLES still updates; afterwards the gyro bias is
+  // re-measured whenever the device sits still. Results persist in EEPROM.
+  void startCalibration();
+  bool loadCalibration();  // False if none stored or taken at another temperature
+  bool isCalibrating() const { return calibrationState == CAL_FULL; }
 
   MotionData getMotionData() const { return motionData; }
+
+  // Motion at timeMicros: interpolated between stored samples, or
+  // extrapolated from the newest one along its gyro rates
+  MotionData getMotionDataAt(unsigned long timeMicros) const;
+
+  // Frame timing. predictDisplayMicros() estimates when a frame started at
+  // frameStartMicros reaches the LEDs; recordFrameDisplayed() feeds back
+  // when it actually did, tuning the estimate and the latency stats.
+  unsigned long predictDisplayMicros(unsigned long frameStartMicros) const {
+    return frameStartMicros + displayLeadMicros;
+  }
+  void recordFrameDisplayed(unsigned long frameStartMicros, unsigned long displayMicros);
+  const MotionLatencyStats& getLatencyStats() const { return latency; }
+  void resetLatencyStats();
+  void printLatencyReport() const;
+  const OrientationFilter& getOrientation() const { return orientation; }
+
+#if ENABLE_GESTURES
+  // Gesture events, oldest first, as soon as the sensor task has seen them
+  bool pollGesture(GestureEvent& event) { return gestures.poll(event); }
+  const GestureDetector& getGestures() const { return gestures; }
+#endif
   bool isCalibrated() const { return calibrated; }
 
   // Getters for specific motion characteristics
@@ -49,21 +107,73 @@ public:
   float getShakeNormalized() const { return motionData.shakeNormalized; }
 
 private:
+#if MPU_USE_FIFO
+  MPU6050Fifo mpu;
+  uint8_t temperatureCountdown;
+#else
   Adafruit_MPU6050 mpu;
+#endif
   MotionData motionData;
+  OrientationFilter orientation;
+#if ENABLE_GESTURES
+  GestureDetector gestures;
+#endif
+#if ENABLE_MOTION_SPECTRUM
+  MotionSpectrum spectrum;
+#endif
+  unsigned long lastSampleMicros;
+  uint32_t batchSpanMicros;  // Time covered by the last readSensor() batch
+
+  // Timestamped history for frame-time interpolation
+  struct MotionSnapshot {
+    unsigned long micros;  // When the sample was measured
+    MotionData data;
+  };
+  MotionSnapshot history[MOTION_HISTORY_SIZE];
+  uint8_t historyHead;   // Newest snapshot
+  uint8_t historyCount;
+
+  // Display timing
+  unsigned long displayLeadMicros;
+  MotionLatencyStats latency;
 
-  // Calibration offsets
-  float accelXOffset, accelYOffset, accelZOffset;
+  // Calibration offsets in sensor units (accel and gyro bias)
+  RawMotionSample offsets;
   bool calibrated;
 
+  enum CalibrationState : uint8_t { CAL_IDLE, CAL_FULL, CAL_BACKGROUND };
+  CalibrationState calibrationState;
+  uint8_t calibrationCount;
+  int32_t calibrationSums[6];        // Uncalibrated accel XYZ, gyro XYZ
+  RawMotionSample previousGyro;      // Last update's average, for stillness
+  RawMotionSample savedGyroOffsets;  // What EEPROM holds
+
+  struct StoredCalibration {
+    uint16_t magic;
+    RawMotionSample offsets;
+    int16_t tempCenti;  // Temperature at calibration, C * 100
+    uint8_t checksum;
+  };
+  StoredCalibration pendingCalibration;  // Being written to EEPROM a byte at a time
+  uint8_t pendingCalibrationByte;        // Next byte to write; sizeof(StoredCalibration) when idle
+
   // Smoothing
-  float prevTilt, prevRotation, prevShake;
+  float prevRotation, prevShake;
 
   // Helper functions
+  bool readSensor(RawMotionSample& average);
+  void processSample(RawMotionSample& sample, uint16_t dtMicros);
+  bool isStill(const RawMotionSample& average) const;
+  void updateCalibration(const RawMotionSample& average);
+  void finishCalibration();
+  void saveCalibration();
+  void writePendingCalibration();
+  static uint8_t calibrationChecksum(const StoredCalibration& stored);
   void calculateOrientation();
   void calculateMotionCharacteristics();
   void applySmoothing();
-  float mapToNormalized(float value, float threshold, float maxValue);
+  void extrapolate(MotionData& data, unsigned long aheadMicros) const;
+  float mapToNormalized(float value, float threshold, float maxValue) const;
 };
 
 #endif
@@ -0,0 +1,20 @@
+#ifndef MOTION_SAMPLE_H
+#define MOTION_SAMPLE_H
+
+#include <Arduino.h>
+
+// One IMU reading in sensor units, shared by the FIFO driver and the
+// orientation filter so neither has to go through float.
+//
+// Scales match the ranges MotionProcessor configures:
+//   accel: 4096 LSB/g at +-8 g
+//   gyro:  65.5 LSB/(deg/s) at +-500 deg/s
+struct RawMotionSample {
+  int16_t accelX, accelY, accelZ;
+  int16_t gyroX, gyroY, gyroZ;
+};
+
+#define MPU_ACCEL_LSB_PER_G 4096
+#define MPU_GYRO_LSB_PER_DPS_X10 655   // 65.5 LSB per deg/s, times 10
+
+#endif
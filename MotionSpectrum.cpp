@@ -0,0 +1,99 @@
+#include "MotionSpectrum.h"
+#include <math.h>
+
+static_assert(SPECTRUM_BLOCK == 128, "Regenerate SPECTRUM_COEFFS for the new SPECTRUM_BLOCK");
+
+// Bin k of a SPECTRUM_BLOCK-sample block, and 2cos(2 pi k / SPECTRUM_BLOCK) in Q14
+static const uint8_t SPECTRUM_K[SPECTRUM_BINS] PROGMEM = { 1, 2, 3, 4, 6, 8, 12, 16 };
+static const int16_t SPECTRUM_COEFFS[SPECTRUM_BINS] PROGMEM = {
+  32729, 32610, 32413, 32138, 31357, 30274, 27246, 23170
+};
+
+// (s * c) >> 14 for |s| < 2^26 without a 64-bit product: s = hi * 2^14 + lo
+// with 0 <= lo < 2^14, so the result is hi * c + (lo * c) >> 14 exactly
+static inline int32_t mulQ14(int32_t s, int16_t c) {
+  int32_t hi = s >> 14;
+  int32_t lo = s & 0x3FFF;
+  return hi * c + ((lo * c) >> 14);
+}
+
+MotionSpectrum::MotionSpectrum() {
+  reset();
+}
+
+void MotionSpectrum::reset() {
+  memset(s1, 0, sizeof(s1));
+  memset(s2, 0, sizeof(s2));
+  memset(gravity, 0, sizeof(gravity));
+  count = 0;
+  memset(levels, 0, sizeof(levels));
+  frequency = 0;
+  rhythmShare = 0;
+}
+
+bool MotionSpectrum::add(int16_t accelXmg, int16_t accelYmg) {
+  int16_t input[SPECTRUM_AXES] = { accelXmg, accelYmg };
+
+  for (uint8_t axis = 0; axis < SPECTRUM_AXES; axis++) {
+    // Gravity (and slow tilt) out: a one-pole high-pass at ~0.25 Hz
+    int32_t x = input[axis];
+    gravity[axis] += x - (gravity[axis] >> 6);
+    x -= gravity[axis] >> 6;
+    x = constrain(x, -SPECTRUM_INPUT_LIMIT_MG, SPECTRUM_INPUT_LIMIT_MG);
+
+    int32_t* a = s1[axis];
+    int32_t* b = s2[axis];
+    for (uint8_t bin = 0; bin < SPECTRUM_BINS; bin++) {
+      int32_t s = x + mulQ14(a[bin], pgm_read_word(&SPECTRUM_COEFFS[bin])) - b[bin];
+      b[bin] = a[bin];
+      a[bin] = s;
+    }
+  }
+
+  if (++count < SPECTRUM_BLOCK) return false;
+  finishBlock();
+  return true;
+}
+
+// Bin powers (|X|^2 = s1^2 + s2^2 - coeff * s1 * s2), summed over both
+// axes, then the filters restart for the next block
+void MotionSpectrum::finishBlock() {
+  float power[SPECTRUM_BINS];
+  float total = 0;
+  uint8_t strongest = 0;
+
+  for (uint8_t bin = 0; bin < SPECTRUM_BINS; bin++) {
+    float coeff = (int16_t)pgm_read_word(&SPECTRUM_COEFFS[bin]) / 16384.0;
+    power[bin] = 0;
+    for (uint8_t axis = 0; axis < SPECTRUM_AXES; axis++) {
+      float a = s1[axis][bin];
+      float b = s2[axis][bin];
+      power[bin] += a * a + b * b - coeff * a * b;
+    }
+    if (power[bin] < 0) power[bin] = 0;
+    total += power[bin];
+    if (power[bin] > power[strongest]) strongest = bin;
+
+    // A sinusoid of amplitude A on the bin gives |X| = A * N / 2
+    float amplitude = 2.0 * sqrt(power[bin]) / SPECTRUM_BLOCK;
+    float level = amplitude * 255 / SPECTRUM_FULL_SCALE_MG;
+    levels[bin] = level > 255 ? 255 : (uint8_t)level;
+  }
+
+  float peak = 2.0 * sqrt(power[strongest]) / SPECTRUM_BLOCK;
+  if (peak >= SPECTRUM_MIN_MG && total > 0) {
+    frequency = binFrequency(strongest);
+    rhythmShare = power[strongest] / total;
+  } else {
+    frequency = 0;
+    rhythmShare = 0;
+  }
+
+  memset(s1, 0, sizeof(s1));
+  memset(s2, 0, sizeof(s2));
+  count = 0;
+}
+
+float MotionSpectrum::binFrequency(uint8_t bin) {
+  return (float)pgm_read_byte(&SPECTRUM_K[bin]) * MPU_UPDATE_RATE / SPECTRUM_BLOCK;
+}
@@ -0,0 +1,67 @@
+#ifndef MOTION_SPECTRUM_H
+#define MOTION_SPECTRUM_H
+
+#include <Arduino.h>
+#include "Config.h"
+
+// Frequency analysis of sway and shake (ENABLE_MOTION_SPECTRUM).
+//
+// A bank of fixed-point Goertzel filters runs over blocks of
+// SPECTRUM_BLOCK sensor updates (1.28 s at 100 Hz) of the horizontal
+// accelerometer axes, after a slow high-pass takes gravity out. The bins
+// sit at k * MPU_UPDATE_RATE / SPECTRUM_BLOCK for the k in binK[]:
+// 0.78, 1.56, 2.34, 3.13, 4.69, 6.25, 9.38 and 12.5 Hz at 100 Hz, from a
+// hanging tube's sway up to a hand-held buzz.
+//
+// Per update each filter does s = x + 2cos(w) * s1 - s2 with the
+// coefficient in Q14, split so the product never needs 64 bits: two
+// 32-bit multiplies and three adds, for 2 axes x 8 bins. The magnitudes
+// are taken in float only at the end of a block, once every 1.28 s.
+//
+// The AVR cost has not been measured, and no speedup over a float bank
+// is claimed: on the host, kernel_bench's "spectrum update" runs at
+// 0.9-1.1x of the float version. To measure it on the AVR, run
+// host/simavr's bench twice, the second time with
+// FIRMWARE_FLAGS=-DENABLE_MOTION_SPECTRUM=0; the difference in
+// sensor_avg is the bank's cost per sensor run.
+//
+// Results, held until the next block completes: per-bin amplitude in mg,
+// the strongest bin's frequency and its share of the total energy (how
+// rhythmic the motion is).
+
+#define SPECTRUM_BLOCK 128          // Updates per block; binK[] coefficients assume 128
+#define SPECTRUM_BINS 8
+#define SPECTRUM_AXES 2
+#define SPECTRUM_INPUT_LIMIT_MG 4000  // Keeps filter state under 2^26 for the split multiply
+#define SPECTRUM_MIN_MG 25          // A weaker peak doesn't count as a rhythm
+#define SPECTRUM_FULL_SCALE_MG 1000 // Amplitude reported as level 255
+
+class MotionSpectrum {
+public:
+  MotionSpectrum();
+  void reset();
+
+  // One sensor update's horizontal acceleration in mg; true when it
+  // completed a block and the results changed
+  bool add(int16_t accelXmg, int16_t accelYmg);
+
+  float dominantFrequency() const { return frequency; }  // Hz, 0 if nothing stands out
+  float rhythm() const { return rhythmShare; }            // 0-1
+  uint8_t level(uint8_t bin) const { return levels[bin]; }  // 0-255 of SPECTRUM_FULL_SCALE_MG
+
+  static float binFrequency(uint8_t bin);
+
+private:
+  int32_t s1[SPECTRUM_AXES][SPECTRUM_BINS];
+  int32_t s2[SPECTRUM_AXES][SPECTRUM_BINS];
+  int32_t gravity[SPECTRUM_AXES];  // High-pass state, mg x 64
+  uint8_t count;
+
+  uint8_t levels[SPECTRUM_BINS];
+  float frequency;
+  float rhythmShare;
+
+  void finishBlock();
+};
+
+#endif
@@ -0,0 +1,63 @@
+#include "OrientationFilter.h"
+
+// 2^32 / (65.5 LSB per deg/s * 360 deg * 1e6 us), Q16
+#define GYRO_TURN32_PER_LSB_US_Q16 11937UL
+
+// Longer gaps are clamped; the accelerometer pulls the angles back
+#define FUSION_MAX_DT_US 20000
+
+// Squared accel magnitude window in which gravity is trusted
+static const uint32_t ACCEL_MIN_SQ =
+    (uint32_t)(MPU_ACCEL_LSB_PER_G * (1.0 - FUSION_ACCEL_TOLERANCE)) *
+    (uint32_t)(MPU_ACCEL_LSB_PER_G * (1.0 - FUSION_ACCEL_TOLERANCE));
+static const uint32_t ACCEL_MAX_SQ =
+    (uint32_t)(MPU_ACCEL_LSB_PER_G * (1.0 + FUSION_ACCEL_TOLERANCE)) *
+    (uint32_t)(MPU_ACCEL_LSB_PER_G * (1.0 + FUSION_ACCEL_TOLERANCE));
+
+OrientationFilter::OrientationFilter() {
+  reset();
+}
+
+void OrientationFilter::reset() {
+  pitch = 0;
+  roll = 0;
+  yaw = 0;
+  seeded = false;
+}
+
+void OrientationFilter::integrate(const RawMotionSample& sample, uint16_t dtMicros) {
+  if (dtMicros > FUSION_MAX_DT_US) dtMicros = FUSION_MAX_DT_US;
+
+  // Split the scale so rate * scale stays inside 32 bits at full range
+  int32_t scale = ((uint32_t)dtMicros * GYRO_TURN32_PER_LSB_US_Q16) >> 12;
+
+  pitch += ((int32_t)sample.gyroX * scale) >> 4;
+  roll += ((int32_t)sample.gyroY * scale) >> 4;
+  yaw += ((int32_t)sample.gyroZ * scale) >> 4;
+}
+
+void OrientationFilter::correct(int16_t accelX, int16_t accelY, int16_t accelZ, uint16_t dtMicros) {
+  int32_t ax = accelX, ay = accelY, az = accelZ;
+  uint32_t magnitudeSq = (uint32_t)(ax * ax) + (uint32_t)(ay * ay) + (uint32_t)(az * az);
+  if (magnitudeSq < ACCEL_MIN_SQ || magnitudeSq > ACCEL_MAX_SQ) return;
+
+  // Same conventions as the old accelerometer-only estimate
+  phase16_t accelPitch = iatan2(ay, isqrt32((uint32_t)(ax * ax) + (uint32_t)(az * az)));
+  phase16_t accelRoll = iatan2(-ax, az);
+
+  if (!seeded) {
+    pitch = (uint32_t)accelPitch << 16;
+    roll = (uint32_t)accelRoll << 16;
+    seeded = true;
+    return;
+  }
+
+  // Gain dt / tau in Q16; error (int16) * gain lands in 2^32-per-turn units
+  uint32_t gain = ((uint32_t)dtMicros << 16) / (FUSION_TIME_CONSTANT_MS * 1000UL);
+  if (gain > 0xFFFF) gain = 0xFFFF;
+
+  int16_t pitchError = (int16_t)(accelPitch - getPitch());
+  int16_t rollError = (int16_t)(accelRoll - getRoll());
+  pitch += (int32_t)pitchError * (int32_t)gain;
+  roll += (int32_t)rollError * (int32_t)gain;
+}
@@ -0,0 +1,48 @@
+#ifndef ORIENTATION_FILTER_H
+#define ORIENTATION_FILTER_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include "FixedMath.h"
+#include "MotionSample.h"
+
+// Complementary filter that fuses the gyro and accelerometer into pitch,
+// roll and yaw (pan), entirely in integer math.
+//
+// integrate() runs per gyro sample, so angles follow motion immediately;
+// correct() pulls pitch and roll toward the gravity vector with time
+// constant FUSION_TIME_CONSTANT_MS to cancel gyro drift. Yaw has no
+// absolute reference and is relative to power-on, drifting with whatever
+// gyro bias calibration leaves behind.
+//
+// Angles are kept as 32-bit fractions of a turn (2^32 = 360 degrees), so
+// the top 16 bits are a phase16_t and wraparound is free.
+
+class OrientationFilter {
+public:
+  OrientationFilter();
+
+  void reset();
+
+  // Add one gyro sample taken dtMicros after the previous one
+  void integrate(const RawMotionSample& sample, uint16_t dtMicros);
+
+  // Blend pitch/roll toward the accelerometer's gravity estimate.
+  // Skipped while the total acceleration is far from 1 g (shaking).
+  void correct(int16_t accelX, int16_t accelY, int16_t accelZ, uint16_t dtMicros);
+
+  // Angles as phases; read as int16_t for -180..180 degrees
+  phase16_t getPitch() const { return pitch >> 16; }
+  phase16_t getRoll() const { return roll >> 16; }
+  phase16_t getYaw() const { return yaw >> 16; }
+
+  float getPitchDegrees() const { return (int16_t)getPitch() * (360.0 / 65536.0); }
+  float getRollDegrees() const { return (int16_t)getRoll() * (360.0 / 65536.0); }
+  float getYawDegrees() const { return (int16_t)getYaw() * (360.0 / 65536.0); }
+
+private:
+  uint32_t pitch, roll, yaw;
+  bool seeded;
+};
+
+#endif
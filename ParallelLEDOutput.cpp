@@ -0,0 +1,174 @@
+#include "ParallelLEDOutput.h"
+
+#define PARALLEL_LANE_MASK ((uint8_t)((1U << NUM_SEGMENTS) - 1))
+
+// The longest segment sets how many pixel positions every lane sends
+static constexpr uint16_t PARALLEL_POSITIONS = SegmentLayout::maxLength();
+
+unsigned long ParallelLEDOutput::frameMicros() {
+  return (unsigned long)PARALLEL_POSITIONS * (24 * PARALLEL_BIT_CYCLES + PARALLEL_PIXEL_GAP_CYCLES) /
+         (F_CPU / 1000000UL);
+}
+
+// One pixel position, colour-major: pixel[k * 3 + lane] is colour byte k
+// (G, R, B) of that lane, scaled; lanes past NUM_SEGMENTS and padding
+// past a segment's end stay black
+void ParallelLEDOutput::gatherPixel(const CRGB* leds, uint16_t position, uint8_t brightness) {
+  for (uint8_t lane = 0; lane < PARALLEL_MAX_LANES; lane++) {
+    uint8_t* out = pixel + lane;
+    if (lane >= NUM_SEGMENTS || position >= SegmentLayout::length(lane)) {
+      out[0] = out[3] = out[6] = 0;
+      continue;
+    }
+
+    const CRGB& color = leds[SegmentLayout::start(lane) + position];
+    out[0] = scale8(color.g, brightness);
+    out[3] = scale8(color.r, brightness);
+    out[6] = scale8(color.b, brightness);
+  }
+}
+
+#if defined(__AVR__)
+
+#if !defined(LED_PARALLEL_PORT) || !defined(LED_PARALLEL_DDR)
+#error "LED_PARALLEL_PORT and LED_PARALLEL_DDR must name one I/O port"
+#endif
+
+void ParallelLEDOutput::begin() {
+  memset(pixel, 0, sizeof(pixel));
+  LED_PARALLEL_DDR |= PARALLEL_LANE_MASK;
+  LED_PARALLEL_PORT = 0;
+}
+
+// One bit: t=0 high, t=6 the plane in p (zeros drop), t=12 low. Between
+// them the plane for the next bit is shifted out of a, b and c into n,
+// lane 0 in bit 0. SLOT_B (2 cycles) and SLOT_C (7) are what is left.
+#define PARALLEL_BIT(a, b, c, SLOT_B, SLOT_C) \
+  "out  %[port], %[high]      \n\t"  /* t=0 */ \
+  "clr  %[n]                  \n\t" \
+  "lsl  %[" c "]              \n\t" \
+  "rol  %[n]                  \n\t" \
+  "lsl  %[" b "]              \n\t" \
+  "rol  %[n]                  \n\t" \
+  "out  %[port], %[p]         \n\t"  /* t=6: zeros drop */ \
+  "lsl  %[" a "]              \n\t" \
+  "rol  %[n]                  \n\t" \
+  "mov  %[p], %[n]            \n\t" \
+  SLOT_B \
+  "out  %[port], __zero_reg__ \n\t"  /* t=12: ones drop */ \
+  SLOT_C
+
+#define PARALLEL_WAIT2 "rjmp .+0 \n\t"
+#define PARALLEL_WAIT7 PARALLEL_WAIT2 PARALLEL_WAIT2 PARALLEL_WAIT2 "nop \n\t"
+#define PARALLEL_LOAD(reg) "ld   %[" reg "], %a[src]+ \n\t"
+#define PARALLEL_CURRENT_BIT(SLOT_B) PARALLEL_BIT("a", "b", "c", SLOT_B, PARALLEL_WAIT7)
+
+void ParallelLEDOutput::show(const CRGB* leds, uint8_t brightness) {
+  for (uint16_t position = 0; position < PARALLEL_POSITIONS; position++) {
+    gatherPixel(leds, position, brightness);
+
+    const uint8_t* src = pixel;
+    uint8_t a, b, c, na, nb, nc, n, p;
+    uint8_t count = 3;
+
+    // 20 cycles per bit; see the timing table in ParallelLEDOutput.h. Bits
+    // 0-2 of each colour load the next colour's bytes, bit 7 shifts the
+    // first plane out of them and makes them current.
+    noInterrupts();
+    asm volatile(
+      "ld   %[a], %a[src]+        \n\t"
+      "ld   %[b], %a[src]+        \n\t"
+      "ld   %[c], %a[src]+        \n\t"
+      "clr  %[p]                  \n\t"
+      "lsl  %[c]                  \n\t"
+      "rol  %[p]                  \n\t"
+      "lsl  %[b]                  \n\t"
+      "rol  %[p]                  \n\t"
+      "lsl  %[a]                  \n\t"
+      "rol  %[p]                  \n\t"
+      "1:                         \n\t"
+      PARALLEL_CURRENT_BIT(PARALLEL_LOAD("na"))
+      PARALLEL_CURRENT_BIT(PARALLEL_LOAD("nb"))
+      PARALLEL_CURRENT_BIT(PARALLEL_LOAD("nc"))
+      PARALLEL_CURRENT_BIT(PARALLEL_WAIT2)
+      PARALLEL_CURRENT_BIT(PARALLEL_WAIT2)
+      PARALLEL_CURRENT_BIT(PARALLEL_WAIT2)
+      PARALLEL_CURRENT_BIT(PARALLEL_WAIT2)
+      PARALLEL_BIT("na", "nb", "nc", PARALLEL_WAIT2,
+        "mov  %[a], %[na]           \n\t"
+        "mov  %[b], %[nb]           \n\t"
+        "mov  %[c], %[nc]           \n\t"
+        "nop                        \n\t"
+        "dec  %[count]              \n\t"
+        "brne 1b                    \n\t")
+      : [a] "=&r" (a), [b] "=&r" (b), [c] "=&r" (c),
+        [na] "=&r" (na), [nb] "=&r" (nb), [nc] "=&r" (nc),
+        [n] "=&r" (n), [p] "=&r" (p),
+        [src] "+e" (src), [count] "+r" (count)
+      : [port] "I" (_SFR_IO_ADDR(LED_PARALLEL_PORT)), [high] "r" (PARALLEL_LANE_MASK)
+    );
+    interrupts();
+  }
+}
+
+#else
+
+// Host build: the same transpose, with the port writes the AVR loop
+// would make reported to the hook at the cycles they would happen
+static ParallelLEDOutput::PortWriteHook portWriteHook = nullptr;
+
+void ParallelLEDOutput::setPortWriteHook(PortWriteHook hook) {
+  portWriteHook = hook;
+}
+
+void ParallelLEDOutput::begin() {
+  memset(pixel, 0, sizeof(pixel));
+}
+
+// What one bit of the AVR loop shifts into the next port value
+static uint8_t shiftPlane(uint8_t& a, uint8_t& b, uint8_t& c) {
+  uint8_t plane = (a >> 7) | (b >> 7) << 1 | (c >> 7) << 2;
+  a <<= 1;
+  b <<= 1;
+  c <<= 1;
+  return plane;
+}
+
+void ParallelLEDOutput::show(const CRGB* leds, uint8_t brightness) {
+  uint32_t cycle = 0;
+
+  for (uint16_t position = 0; position < PARALLEL_POSITIONS; position++) {
+    gatherPixel(leds, position, brightness);
+
+    const uint8_t* src = pixel;
+    uint8_t a = *src++, b = *src++, c = *src++;
+    uint8_t na = 0, nb = 0, nc = 0;
+    uint8_t p = shiftPlane(a, b, c);
+
+    for (uint8_t colour = 0; colour < 3; colour++) {
+      for (uint8_t bit = 0; bit < 8; bit++) {
+        if (portWriteHook) {
+          portWriteHook(cycle, PARALLEL_LANE_MASK);
+          portWriteHook(cycle + PARALLEL_T0H_CYCLES, p);
+          portWriteHook(cycle + PARALLEL_T1H_CYCLES, 0);
+        }
+        cycle += PARALLEL_BIT_CYCLES;
+
+        if (bit == 7) {
+          p = shiftPlane(na, nb, nc);
+          a = na;
+          b = nb;
+          c = nc;
+          continue;
+        }
+        p = shiftPlane(a, b, c);
+        if (bit == 0) na = *src++;
+        if (bit == 1) nb = *src++;
+        if (bit == 2) nc = *src++;
+      }
+    }
+    cycle += PARALLEL_PIXEL_GAP_CYCLES;
+  }
+}
+
+#endif
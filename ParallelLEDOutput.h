@@ -0,0 +1,78 @@
+#ifndef PARALLEL_LED_OUTPUT_H
+#define PARALLEL_LED_OUTPUT_H
+
+#include <FastLED.h>
+#include "Config.h"
+#include "SegmentLayout.h"
+
+// Parallel bit-banged WS2812 output: one data line per segment, all lanes
+// clocked together on one port (LED_PARALLEL_OUTPUT).
+//
+// Segment n leaves on bit n of LED_PARALLEL_PORT (PORTA: pin 22 + n on the
+// Mega). It is wired to the LED at the segment's start index, so each lane
+// streams its segment in buffer order, and reversal stays with
+// SegmentLayout exactly as on a single chain. Shorter segments are padded
+// with black, which falls off the end of their strip.
+//
+// Per pixel position, the nine colour bytes of up to three lanes are
+// scaled and gathered lane by lane (G0 G1 G2 R0 R1 R2 B0 B1 B2). Then 24
+// bits go out with interrupts off, 20 cycles each at 16 MHz:
+//
+//   t=0   all lanes high
+//   t=6   lanes sending 0 drop (375 ns high)
+//   t=12  lanes sending 1 drop (750 ns high)
+//
+// The transpose happens inside the bit loop. Each bit's spare cycles
+// shift the top bit of every lane's byte into the port value for the next
+// bit (clr, then lsl/rol per lane: 7 cycles) and load the next colour's
+// bytes, so no bit planes are built between pixels. That per-bit shifting
+// is why there are at most three lanes.
+//
+// Interrupts run again between pixels. That gap (gathering and scaling
+// the next position, about PARALLEL_PIXEL_GAP_CYCLES, plus any ISR) must
+// stay well below WS2812_LATCH_US. The whole port is written, so its other
+// pins can't be used for anything else.
+//
+// Wire time is the longest segment rather than the whole strip: 70 pixels
+// x (30 us + ~10 us gap) = ~2.8 ms, against ~6.3 ms serial. The gap figure
+// is an estimate from the C it runs. host/simavr's avr_bench --parallel
+// decodes the real PORTA lines of a firmware built with
+// LED_PARALLEL_OUTPUT=1 and reports the gap and wire time. The host build
+// replays the bit loop, with the gap estimate, and reports every port write
+// with its cycle to a hook, so host/parallel_capture can check the bit
+// layout.
+
+#define PARALLEL_MAX_LANES 3
+#define PARALLEL_BIT_CYCLES 20
+#define PARALLEL_T0H_CYCLES 6
+#define PARALLEL_T1H_CYCLES 12
+#define PARALLEL_PIXEL_GAP_CYCLES 160   // Estimated gather of one pixel position plus loop entry
+
+static_assert(NUM_SEGMENTS <= PARALLEL_MAX_LANES, "Parallel output has one port bit per segment, three at most");
+
+class ParallelLEDOutput {
+public:
+  void begin();
+
+  // Send leds[] (buffer order) with brightness applied; blocks until the
+  // last bit is out
+  void show(const CRGB* leds, uint8_t brightness);
+
+  // Time on the wire for one frame, latch excluded
+  static unsigned long frameMicros();
+
+#if !defined(__AVR__)
+  // Host build: every port write as (cycle since show() began, port value)
+  typedef void (*PortWriteHook)(uint32_t cycle, uint8_t value);
+  static void setPortWriteHook(PortWriteHook hook);
+#endif
+
+private:
+  void gatherPixel(const CRGB* leds, uint16_t position, uint8_t brightness);
+
+  // Colour-major, lane-minor; one colour past the end: the send loop loads
+  // the next colour's bytes during the last one too
+  uint8_t pixel[PARALLEL_MAX_LANES * 4];
+};
+
+#endif
@@ -0,0 +1,121 @@
+#include "QualityGovernor.h"
+
+QualityGovernor::QualityGovernor()
+  : showAverage8(0), adjustments(0) {
+  reset(false);
+}
+
+void QualityGovernor::reset(bool tieredMode) {
+  tiered = tieredMode;
+  currentTier = QUALITY_FULL;
+  periodMicros = FRAME_PERIOD_US;
+  renderAverage8 = 0;
+  renderSamples = 0;
+  stepRenderMicros = 0;
+  for (uint8_t t = 0; t < QUALITY_TIERS; t++) {
+    finerRatio256[t] = 512;  // Replaced by a measurement before it is used
+  }
+  overBudgetFrames = 0;
+  headroomFrames = 0;
+  // showAverage8 carries over: the strip costs the same in every mode
+}
+
+// What render may take at this period once the strip has been sent
+unsigned long QualityGovernor::renderBudget(unsigned long period, uint8_t percent) const {
+  unsigned long usable = period / 100 * GOVERNOR_BUDGET_PERCENT;
+  unsigned long show = averageShowMicros();
+  if (show >= usable) return 0;
+  return (usable - show) / 100 * percent;
+}
+
+bool QualityGovernor::update(unsigned long renderMicros, unsigned long showMicros, bool sent) {
+  if (sent) showAverage8 += showMicros - showAverage8 / 8;
+
+  // After a tier change the average restarts, so it describes the new tier
+  if (renderSamples == 0) {
+    renderAverage8 = renderMicros * 8;
+  } else {
+    renderAverage8 += renderMicros - renderAverage8 / 8;
+  }
+  if (renderSamples < 8) {
+    if (++renderSamples < 8) return false;
+    if (stepRenderMicros) {
+      unsigned long render = averageRenderMicros();
+      unsigned long ratio = render ? stepRenderMicros * 256 / render : 256;
+      finerRatio256[currentTier] = ratio < 256 ? 256 : (ratio > 4096 ? 4096 : ratio);
+      stepRenderMicros = 0;
+    }
+  }
+
+  unsigned long render = averageRenderMicros();
+
+  if (render > renderBudget(periodMicros, 100)) {
+    headroomFrames = 0;
+    if (++overBudgetFrames < GOVERNOR_DOWNGRADE_FRAMES) return false;
+    bool canStepTier = tiered && currentTier != QUALITY_QUARTER;
+    if (!canStepTier && periodMicros >= GOVERNOR_MAX_PERIOD_US) {
+      overBudgetFrames = 0;  // Nothing left to give
+      return false;
+    }
+    stepDown();
+    return true;
+  }
+  overBudgetFrames = 0;
+
+  // Render at the next rung up: a shorter period first, then a finer tier
+  unsigned long nextPeriod = periodMicros;
+  unsigned long nextRender = render;
+  if (periodMicros > FRAME_PERIOD_US) {
+    nextPeriod = periodMicros - periodMicros / 8;
+    if (nextPeriod < FRAME_PERIOD_US) nextPeriod = FRAME_PERIOD_US;
+  } else if (currentTier != QUALITY_FULL) {
+    nextRender = render * finerRatio256[currentTier] / 256;
+  } else {
+    return false;
+  }
+
+  if (nextRender < renderBudget(nextPeriod, GOVERNOR_HEADROOM_PERCENT)) {
+    if (++headroomFrames < GOVERNOR_UPGRADE_FRAMES) return false;
+    stepUp();
+    return true;
+  }
+  headroomFrames = 0;
+  return false;
+}
+
+void QualityGovernor::stepDown() {
+  if (tiered && currentTier != QUALITY_QUARTER) {
+    currentTier = (QualityTier)(currentTier + 1);
+    stepRenderMicros = averageRenderMicros();
+    renderSamples = 0;
+  } else {
+    periodMicros += periodMicros / 8;
+    if (periodMicros > GOVERNOR_MAX_PERIOD_US) periodMicros = GOVERNOR_MAX_PERIOD_US;
+  }
+  overBudgetFrames = 0;
+  headroomFrames = 0;
+  adjustments++;
+}
+
+void QualityGovernor::stepUp() {
+  if (periodMicros > FRAME_PERIOD_US) {
+    periodMicros -= periodMicros / 8;
+    if (periodMicros < FRAME_PERIOD_US) periodMicros = FRAME_PERIOD_US;
+  } else {
+    currentTier = (QualityTier)(currentTier - 1);
+    stepRenderMicros = 0;
+    renderSamples = 0;
+  }
+  overBudgetFrames = 0;
+  headroomFrames = 0;
+  adjustments++;
+}
+
+const char* QualityGovernor::tierName(QualityTier tier) {
+  switch (tier) {
+    case QUALITY_FULL: return "full";
+    case QUALITY_HALF: return "half";
+    case QUALITY_QUARTER: return "quarter";
+    default: return "?";
+  }
+}
@@ -0,0 +1,70 @@
+#ifndef QUALITY_GOVERNOR_H
+#define QUALITY_GOVERNOR_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include "Animations.h"
+
+// Adaptive render quality (ENABLE_QUALITY_GOVERNOR).
+//
+// Keeps running averages (1/8 weight per frame) of render and show time.
+// Show time is only sampled from frames that were actually sent, and the
+// governor can do nothing about it, so render is budgeted against what is
+// left: GOVERNOR_BUDGET_PERCENT of the frame period minus the show time.
+// After GOVERNOR_DOWNGRADE_FRAMES frames in a row over that budget it steps
+// one quality tier down, but only for modes that render tiers (see
+// AnimationRegistry::hasQualityTiers()). When the mode has no tiers, or is
+// already at QUALITY_QUARTER, it stretches the frame period instead, an
+// eighth at a time, up to GOVERNOR_MAX_PERIOD_US.
+//
+// Tiers don't save a fixed share (Kaleidoscope's half tier is only a few
+// percent cheaper than full, since upsampling costs most of what it
+// skips), so a step down measures the real saving: the render average
+// before the step against the average over the first frames after it. Recovery runs the ladder
+// backwards, one rung after GOVERNOR_UPGRADE_FRAMES frames in a row in
+// which the render predicted for the next rung (the same render at the
+// shorter period, or the current render times the measured ratio for the
+// finer tier) stays under GOVERNOR_HEADROOM_PERCENT of that rung's render
+// budget. The gap between the two percentages keeps it from flapping.
+//
+// Call reset() on a mode change: the new mode's cost has nothing to do
+// with the old one's.
+
+class QualityGovernor {
+public:
+  QualityGovernor();
+
+  // Start over at full quality and the nominal period; tiered is whether
+  // the mode now showing renders quality tiers
+  void reset(bool tiered);
+
+  // Feed one frame; true if the tier or the frame period changed
+  bool update(unsigned long renderMicros, unsigned long showMicros, bool sent);
+
+  QualityTier tier() const { return currentTier; }
+  unsigned long framePeriodMicros() const { return periodMicros; }
+  unsigned long averageRenderMicros() const { return renderAverage8 / 8; }
+  unsigned long averageShowMicros() const { return showAverage8 / 8; }
+  uint16_t getAdjustments() const { return adjustments; }
+
+  static const char* tierName(QualityTier tier);
+
+private:
+  bool tiered;
+  QualityTier currentTier;
+  unsigned long periodMicros;
+  unsigned long renderAverage8;  // Running averages x 8
+  unsigned long showAverage8;
+  uint8_t renderSamples;         // Frames averaged since the last tier change (up to 8)
+  unsigned long stepRenderMicros;  // Render before the last step down, until its ratio is known
+  uint16_t finerRatio256[QUALITY_TIERS];  // Render at tier t - 1 over render at tier t, x 256
+  uint8_t overBudgetFrames;
+  uint8_t headroomFrames;
+  uint16_t adjustments;
+
+  unsigned long renderBudget(unsigned long period, uint8_t percent) const;
+  void stepDown();
+  void stepUp();
+};
+
+#endif
@@ -0,0 +1,87 @@
+#include "Scheduler.h"
+
+Scheduler::Scheduler()
+  : taskCount(0) {
+}
+
+int8_t Scheduler::add(const char* name, void (*run)(), unsigned long periodMicros, OverrunPolicy policy) {
+  if (taskCount >= SCHEDULER_MAX_TASKS) return -1;
+
+  ScheduledTask& t = tasks[taskCount++];
+  t.name = name;
+  t.run = run;
+  t.periodMicros = periodMicros;
+  t.nextMicros = micros();
+  t.policy = policy;
+  t.runs = 0;
+  t.lateRuns = 0;
+  t.skippedSlots = 0;
+  t.maxLatenessMicros = 0;
+  return taskCount - 1;
+}
+
+void Scheduler::setPeriod(int8_t task, unsigned long periodMicros) {
+  if (task < 0 || task >= taskCount) return;
+  tasks[task].periodMicros = periodMicros;
+}
+
+void Scheduler::start() {
+  unsigned long now = micros();
+  for (uint8_t i = 0; i < taskCount; i++) {
+    tasks[i].nextMicros = now;
+  }
+}
+
+void Scheduler::run() {
+  for (uint8_t i = 0; i < taskCount; i++) {
+    ScheduledTask& t = tasks[i];
+
+    unsigned long lateness = micros() - t.nextMicros;
+    if ((long)lateness < 0) continue;  // Not due yet
+
+    if (lateness > t.maxLatenessMicros) t.maxLatenessMicros = lateness;
+    t.runs++;
+    t.run();
+
+    // Stay on the grid: the next deadline is one period after this one,
+    // not one period after now
+    t.nextMicros += t.periodMicros;
+
+    if (lateness >= t.periodMicros) {
+      t.lateRuns++;
+      unsigned long missed = lateness / t.periodMicros;
+      if (t.policy == SCHEDULE_SKIP || missed > SCHEDULER_MAX_CATCH_UP) {
+        t.nextMicros += missed * t.periodMicros;
+        t.skippedSlots += missed;
+      }
+    }
+  }
+}
+
+void Scheduler::reset() {
+  for (uint8_t i = 0; i < taskCount; i++) {
+    tasks[i].runs = 0;
+    tasks[i].lateRuns = 0;
+    tasks[i].skippedSlots = 0;
+    tasks[i].maxLatenessMicros = 0;
+  }
+}
+
+void Scheduler::printReport() const {
+  Serial.println("=== Scheduler (period us, runs, late, skipped, max lateness us) ===");
+  for (uint8_t i = 0; i < taskCount; i++) {
+    const ScheduledTask& t = tasks[i];
+    Serial.print(t.name);
+    Serial.print(": ");
+    Serial.print(t.periodMicros);
+    Serial.print(" runs=");
+    Serial.print(t.runs);
+    Serial.print(" late=");
+    Serial.print(t.lateRuns);
+    Serial.print(" skipped=");
+    Serial.print(t.skippedSlots);
+    Serial.print(" maxLate=");
+    Serial.println(t.maxLatenessMicros);
+  }
+  Serial.println();
+}
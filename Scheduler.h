@@ -0,0 +1,65 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+#include "Config.h"
+
+// Cooperative fixed-period task scheduler.
+//
+// Each task has a period in microseconds and a deadline grid anchored at
+// start(): after a run the next deadline advances by exactly one period,
+// so a late run doesn't push later ones back and the average rate is
+// exact (120 FPS is 8333 us, not 8 ms). Tasks run in the order they were
+// added; run() starts each due task at most once per call.
+//
+// A task that starts a full period or more late has missed a deadline.
+// SCHEDULE_SKIP then drops the slots it missed and stays on the grid;
+// SCHEDULE_CATCH_UP keeps them and runs again on the following calls
+// (for work whose results depend on a fixed call count, like filters),
+// giving up after SCHEDULER_MAX_CATCH_UP slots.
+
+#define SCHEDULER_MAX_TASKS 6
+
+enum OverrunPolicy {
+  SCHEDULE_SKIP,
+  SCHEDULE_CATCH_UP
+};
+
+struct ScheduledTask {
+  const char* name;
+  void (*run)();
+  unsigned long periodMicros;
+  unsigned long nextMicros;
+  OverrunPolicy policy;
+
+  uint32_t runs;
+  uint16_t lateRuns;       // Started a period or more after the deadline
+  uint16_t skippedSlots;   // Periods dropped by SCHEDULE_SKIP or a give-up
+  unsigned long maxLatenessMicros;
+};
+
+class Scheduler {
+public:
+  Scheduler();
+
+  // Task id for setPeriod(), or -1 if SCHEDULER_MAX_TASKS are already registered
+  int8_t add(const char* name, void (*run)(), unsigned long periodMicros, OverrunPolicy policy);
+
+  // New period from the task's next deadline on
+  void setPeriod(int8_t task, unsigned long periodMicros);
+
+  // Anchor every task's deadline grid at the current time
+  void start();
+
+  // Run the tasks that are due; call from loop()
+  void run();
+
+  void printReport() const;
+  void reset();
+
+private:
+  ScheduledTask tasks[SCHEDULER_MAX_TASKS];
+  uint8_t taskCount;
+};
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef SEGMENT_LAYOUT_H
+#define SEGMENT_LAYOUT_H
+
+#include <FastLED.h>
+#include "Config.h"
+
+// Compile-time description of how the strip folds into segments.
+//
+// By default NUM_LEDS is split as evenly as possible into NUM_SEGMENTS,
+// with the first (NUM_LEDS % NUM_SEGMENTS) segments one LED longer
+// (209 / 3 -> 70 + 70 + 69). Define SEGMENT_LENGTHS in Config.h as a brace
+// list to use explicit lengths instead. Bit n of SEGMENT_REVERSE_MASK marks
+// segment n as wired end-to-start.
+
+static_assert(NUM_SEGMENTS >= 1 && NUM_SEGMENTS <= 32, "NUM_SEGMENTS must be 1-32");
+static_assert(NUM_LEDS >= NUM_SEGMENTS, "Every segment needs at least one LED");
+
+namespace SegmentLayout {
+
+#ifdef SEGMENT_LENGTHS
+constexpr uint16_t lengths[NUM_SEGMENTS] = SEGMENT_LENGTHS;
+
+constexpr uint16_t length(uint8_t segment) {
+  return lengths[segment];
+}
+
+constexpr uint16_t start(uint8_t segment) {
+  return segment == 0 ? 0 : start(segment - 1) + length(segment - 1);
+}
+#else
+constexpr uint16_t length(uint8_t segment) {
+  return NUM_LEDS / NUM_SEGMENTS + (segment < NUM_LEDS % NUM_SEGMENTS ? 1 : 0);
+}
+
+constexpr uint16_t start(uint8_t segment) {
+  return segment * (NUM_LEDS / NUM_SEGMENTS) +
+         (segment < NUM_LEDS % NUM_SEGMENTS ? segment : NUM_LEDS % NUM_SEGMENTS);
+}
+#endif
+
+constexpr uint16_t end(uint8_t segment) {
+  return start(segment) + length(segment) - 1;
+}
+
+constexpr bool reversed(uint8_t segment) {
+  return (SEGMENT_REVERSE_MASK >> segment) & 1;
+}
+
+// Index of the LED at the segment's logical position 0
+constexpr uint16_t first(uint8_t segment) {
+  return reversed(segment) ? end(segment) : start(segment);
+}
+
+constexpr int8_t stride(uint8_t segment) {
+  return reversed(segment) ? -1 : 1;
+}
+
+constexpr uint16_t maxLength(uint8_t segment = 0) {
+  return segment >= NUM_SEGMENTS ? 0
+         : (length(segment) > maxLength(segment + 1) ? length(segment) : maxLength(segment + 1));
+}
+
+}  // namespace SegmentLayout
+
+static_assert(SegmentLayout::end(NUM_SEGMENTS - 1) == NUM_LEDS - 1,
+              "Segment lengths must add up to NUM_LEDS");
+
+// Direct access to one segment's pixels in logical order: position 0 is the
+// segment's logical start however it is wired. Iterating walks the base
+// pointer by the +-1 stride, so there is no bounds check or direction branch
+// per pixel; operator[] is for sparse access and is not bounds-checked.
+class SegmentSpan {
+public:
+  class iterator {
+  public:
+    iterator(CRGB* pixel, int8_t stride) : pixel(pixel), stride(stride) {}
+
+    CRGB& operator*() const { return *pixel; }
+    CRGB* operator->() const { return pixel; }
+    iterator& operator++() {
+      pixel += stride;
+      return *this;
+    }
+    bool operator==(const iterator& other) const { return pixel == other.pixel; }
+    bool operator!=(const iterator& other) const { return pixel != other.pixel; }
+
+  private:
+    CRGB* pixel;
+    int8_t stride;
+  };
+
+  SegmentSpan() : firstPixel(nullptr), pixelStride(1), spanLength(0) {}
+  SegmentSpan(CRGB* first, int8_t stride, uint16_t length)
+    : firstPixel(first), pixelStride(stride), spanLength(length) {}
+
+  uint16_t size() const { return spanLength; }
+  int8_t stride() const { return pixelStride; }
+
+  CRGB& operator[](uint16_t position) const {
+    return pixelStride > 0 ? firstPixel[position] : *(firstPixel - position);
+  }
+
+  iterator begin() const { return iterator(firstPixel, pixelStride); }
+  iterator end() const { return iterator(firstPixel + (int16_t)spanLength * pixelStride, pixelStride); }
+
+private:
+  CRGB* firstPixel;
+  int8_t pixelStride;
+  uint16_t spanLength;
+};
+
+#endif
@@ -0,0 +1,59 @@
+#include "Telemetry.h"
+#if defined(__AVR__)
+#include <util/crc16.h>
+#endif
+
+static_assert((TELEMETRY_RING_SIZE & (TELEMETRY_RING_SIZE - 1)) == 0 && TELEMETRY_RING_SIZE <= 128,
+              "TELEMETRY_RING_SIZE must be a power of two no larger than 128");
+static_assert(TELEMETRY_HEADER_BYTES + TELEMETRY_MAX_PAYLOAD + 1 <= TELEMETRY_RING_SIZE,
+              "TELEMETRY_RING_SIZE must hold the largest record");
+
+// CRC-8 step (poly 0x07); avr-libc has it as _crc8_ccitt_update
+uint8_t telemetryCrc8(uint8_t crc, uint8_t data) {
+#if defined(__AVR__)
+  return _crc8_ccitt_update(crc, data);
+#else
+  crc ^= data;
+  for (uint8_t bit = 0; bit < 8; bit++) {
+    crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+  }
+  return crc;
+#endif
+}
+
+Telemetry::Telemetry()
+  : head(0), tail(0), droppedRecords(0) {
+}
+
+bool Telemetry::write(uint8_t type, uint8_t version, const void* payload, uint8_t length) {
+  uint8_t free = TELEMETRY_RING_SIZE - pending();
+  if (length > TELEMETRY_MAX_PAYLOAD || TELEMETRY_HEADER_BYTES + length + 1 > free) {
+    droppedRecords++;
+    return false;
+  }
+
+  put(TELEMETRY_SYNC1);
+  put(TELEMETRY_SYNC2);
+  put(type);
+  put(version);
+  put(length);
+
+  uint8_t crc = telemetryCrc8(0, type);
+  crc = telemetryCrc8(crc, version);
+  crc = telemetryCrc8(crc, length);
+  const uint8_t* bytes = (const uint8_t*)payload;
+  for (uint8_t i = 0; i < length; i++) {
+    put(bytes[i]);
+    crc = telemetryCrc8(crc, bytes[i]);
+  }
+  put(crc);
+  return true;
+}
+
+void Telemetry::drain() {
+  int room = Serial.availableForWrite();
+  while (room > 0 && head != tail) {
+    Serial.write(ring[tail++ & (TELEMETRY_RING_SIZE - 1)]);
+    room--;
+  }
+}
@@ -0,0 +1,132 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include "MemoryMonitor.h"
+
+// Binary telemetry stream (ENABLE_BINARY_TELEMETRY).
+//
+// Records are framed as
+//   0xA5 0x5A | type | version | length | payload[length] | crc8
+// with the CRC-8 (poly 0x07) taken over type..payload. Payloads are packed
+// little-endian structs below; a record's version only changes when its
+// layout does, and decoders skip types or versions they don't know using
+// length. Text written to Serial in between is skipped the same way, so
+// host/telemetry_decode resynchronises on the next 0xA5 0x5A.
+//
+// write() copies a whole record into a ring buffer or, if it doesn't fit,
+// drops it and counts the drop; drain() moves only as many bytes as the
+// UART can take without blocking and is called from idle time in loop().
+
+#define TELEMETRY_SYNC1 0xA5
+#define TELEMETRY_SYNC2 0x5A
+#define TELEMETRY_HEADER_BYTES 5   // Sync, type, version, length
+#define TELEMETRY_MAX_PAYLOAD 32
+
+enum TelemetryType {
+  TELEMETRY_MOTION = 1,
+  TELEMETRY_FRAME = 2,
+  TELEMETRY_MODE = 3,
+  TELEMETRY_STATUS = 4,
+  TELEMETRY_POWER = 5,
+  TELEMETRY_GESTURE = 6,
+  TELEMETRY_MEMORY = 7
+};
+
+#define TELEMETRY_MOTION_VERSION 1
+#define TELEMETRY_FRAME_VERSION 1
+#define TELEMETRY_MODE_VERSION 1
+#define TELEMETRY_STATUS_VERSION 2
+#define TELEMETRY_POWER_VERSION 1
+#define TELEMETRY_GESTURE_VERSION 1
+#define TELEMETRY_MEMORY_VERSION 1
+
+// Angles in centidegrees, rates in decidegrees/s, normalized values 0-255
+struct __attribute__((packed)) TelemetryMotion {
+  uint32_t timeMs;
+  int16_t pitch;
+  int16_t roll;
+  int16_t yaw;
+  int16_t yawRate;
+  int16_t rotationSpeed;
+  uint8_t tilt;
+  uint8_t rotation;
+  uint8_t shake;
+};
+
+struct __attribute__((packed)) TelemetryFrame {
+  uint32_t timeMs;
+  uint32_t frame;
+  uint16_t renderMicros;
+  uint16_t showMicros;
+  uint8_t mode;
+  uint8_t sent;        // 0 if show() skipped an unchanged frame
+};
+
+struct __attribute__((packed)) TelemetryMode {
+  uint32_t timeMs;
+  uint8_t from;
+  uint8_t to;
+};
+
+struct __attribute__((packed)) TelemetryStatus {
+  uint32_t timeMs;
+  uint16_t freeRam;
+  uint16_t droppedRecords;  // Telemetry records lost to a full ring
+  uint16_t fps100;          // Measured frame rate x 100
+  uint8_t quality;          // QualityTier
+  uint16_t framePeriodMicros;
+};
+
+struct __attribute__((packed)) TelemetryPower {
+  uint32_t timeMs;
+  uint16_t requestedMilliamps;
+  uint16_t drawnMilliamps;
+  uint32_t limitedFrames;
+  uint32_t skippedFrames;
+};
+
+struct __attribute__((packed)) TelemetryGesture {
+  uint32_t timeMs;
+  uint8_t type;        // GestureType
+  uint8_t autoCycle;   // Auto-cycling state after the gesture was handled
+};
+
+// Bytes; subsystems in MemorySubsystem order (see MemoryMonitor.h)
+struct __attribute__((packed)) TelemetryMemory {
+  uint32_t timeMs;
+  uint16_t freeRam;       // Heap to stack pointer when sent
+  uint16_t stackMargin;   // Smallest free RAM since reset (painted bytes left)
+  uint16_t stackPeak;     // Deepest stack since reset
+  uint16_t staticBytes;   // .data + .bss
+  uint16_t subsystemBytes[MEMORY_SUBSYSTEMS];
+};
+
+static_assert(sizeof(TelemetryMemory) <= TELEMETRY_MAX_PAYLOAD, "TelemetryMemory must fit one record");
+
+uint8_t telemetryCrc8(uint8_t crc, uint8_t data);
+
+class Telemetry {
+public:
+  Telemetry();
+
+  // Queue one record; false (and counted) if the ring is too full
+  bool write(uint8_t type, uint8_t version, const void* payload, uint8_t length);
+
+  // Send what the UART can take right now
+  void drain();
+
+  uint8_t pending() const { return head - tail; }
+  uint16_t getDroppedRecords() const { return droppedRecords; }
+
+private:
+  uint8_t ring[TELEMETRY_RING_SIZE];
+  uint8_t head;  // Free-running; power-of-two ring up to 256 bytes
+  uint8_t tail;
+  uint16_t droppedRecords;
+
+  void put(uint8_t value) { ring[head++ & (TELEMETRY_RING_SIZE - 1)] = value; }
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef WINDOW_STATS_H
+#define WINDOW_STATS_H
+
+#include <Arduino.h>
+
+// Mean, variance and peak of the last N values, updated as each value
+// arrives.
+//
+// The sum and sum of squares are adjusted by the value entering and the
+// one leaving the ring, so add() is O(1). The peak comes from a monotonic
+// queue of positions whose values decrease from the front. Each value is
+// pushed and popped at most once, so the peak is amortized O(1) and never
+// more than N steps for one add().
+//
+// Values are clamped to +-WINDOW_STATS_LIMIT so the sum of squares of a
+// 64-value window fits 32 bits. N must be a power of two, 2-64.
+
+#define WINDOW_STATS_LIMIT 8191
+
+template <uint8_t N>
+class WindowStats {
+  static_assert(N >= 2 && N <= 64 && (N & (N - 1)) == 0, "WindowStats size must be a power of two, 2-64");
+
+public:
+  WindowStats() { reset(); }
+
+  void reset() {
+    next = 0;
+    filled = 0;
+    sum = 0;
+    sumSquares = 0;
+    peakFront = 0;
+    peakCount = 0;
+  }
+
+  void add(int16_t value) {
+    if (value > WINDOW_STATS_LIMIT) value = WINDOW_STATS_LIMIT;
+    if (value < -WINDOW_STATS_LIMIT) value = -WINDOW_STATS_LIMIT;
+
+    // The position leaving the window, if it still heads the peak queue
+    if (peakCount && (uint8_t)(next - peakQueue[peakFront]) >= N) {
+      peakFront = (peakFront + 1) & (N - 1);
+      peakCount--;
+    }
+
+    int16_t& slot = values[next & (N - 1)];
+    if (filled == N) {
+      sum -= slot;
+      sumSquares -= (uint32_t)((int32_t)slot * slot);
+    } else {
+      filled++;
+    }
+    slot = value;
+    sum += value;
+    sumSquares += (uint32_t)((int32_t)value * value);
+
+    // Queued values no larger than this one can never be the peak again
+    while (peakCount && values[peakQueue[(peakFront + peakCount - 1) & (N - 1)] & (N - 1)] <= value) {
+      peakCount--;
+    }
+    peakQueue[(peakFront + peakCount) & (N - 1)] = next;
+    peakCount++;
+    next++;
+  }
+
+  uint8_t count() const { return filled; }
+  bool full() const { return filled == N; }
+  int16_t newest() const { return filled ? values[(uint8_t)(next - 1) & (N - 1)] : 0; }
+  int16_t mean() const { return filled ? sum / filled : 0; }
+  int16_t peak() const { return peakCount ? values[peakQueue[peakFront] & (N - 1)] : 0; }
+
+  // Population variance, in squared value units
+  uint32_t variance() const {
+    if (filled == 0) return 0;
+    int32_t m = sum / filled;
+    uint32_t meanSquare = sumSquares / filled;
+    uint32_t squareMean = (uint32_t)(m * m);
+    return meanSquare > squareMean ? meanSquare - squareMean : 0;
+  }
+
+private:
+  int16_t values[N];
+  uint8_t peakQueue[N];  // Positions (mod 256) with decreasing values
+  uint8_t next;          // Position of the next value (mod 256)
+  uint8_t filled;
+  uint8_t peakFront;
+  uint8_t peakCount;
+  int32_t sum;
+  uint32_t sumSquares;
+};
+
+#endif
@@ -0,0 +1,320 @@
+/*
+ * Fixed-point kernel comparison
+ *
+ * Runs each ported Animations primitive next to the original float
+ * implementation over a sweep of inputs and reports cycles per call and the
+ * largest per-channel difference. Cycles are host TSC cycles: the ratio shows
+ * which kernels got cheaper, while absolute AVR soft-float cost is far higher.
+ *
+ * Usage: kernel_bench [--iterations N]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "Config.h"
+#include "LEDController.h"
+#include "Animations.h"
+#include "MotionSpectrum.h"
+
+static uint64_t cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// === Float reference implementations (pre fixed-point port) ===
+
+static CRGB lerpColorFloat(CRGB a, CRGB b, float t) {
+  t = constrain(t, 0.0, 1.0);
+  return CRGB(
+    a.r + (b.r - a.r) * t,
+    a.g + (b.g - a.g) * t,
+    a.b + (b.b - a.b) * t
+  );
+}
+
+static void waveFloat(LEDController& leds, uint8_t hue, uint8_t waveWidth, float position) {
+  for (uint16_t i = 0; i < leds.numLeds(); i++) {
+    float wave = sin((i + position * 10) * 2 * PI / waveWidth);
+    uint8_t brightness = (wave + 1.0) * 127.5;
+    leds.setPixel(i, CHSV(hue, 255, brightness));
+  }
+}
+
+static void gradientFloat(LEDController& leds, CRGB color1, CRGB color2, CRGB color3, float position) {
+  uint16_t numLeds = leds.numLeds();
+
+  for (uint16_t i = 0; i < numLeds; i++) {
+    float adjustedPos = fmod(i + position * numLeds, numLeds);
+    float t = adjustedPos / numLeds;
+
+    CRGB color;
+    if (t < 0.33) {
+      color = lerpColorFloat(color1, color2, t * 3.0);
+    } else if (t < 0.66) {
+      color = lerpColorFloat(color2, color3, (t - 0.33) * 3.0);
+    } else {
+      color = lerpColorFloat(color3, color1, (t - 0.66) * 3.0);
+    }
+
+    leds.setPixel(i, color);
+  }
+}
+
+static void pulseFloat(LEDController& leds, CRGB color, float phase) {
+  uint8_t brightness = (sin(phase * 2 * PI) + 1.0) * 127.5;
+
+  CHSV hsvColor = rgb2hsv_approximate(color);
+  hsvColor.v = brightness;
+
+  leds.fill(hsvColor);
+}
+
+static void motionPulseFloat(LEDController& leds, const MotionData& motion, unsigned long time) {
+  float speed = 1.0 + motion.rotationNormalized * 3.0;
+  uint8_t hue = motion.tiltAngle * 2;
+  uint8_t baseBrightness = 100 + motion.shakeNormalized * 155;
+
+  float phase = (time / 1000.0) * speed;
+  uint8_t brightness = (sin(phase * 2 * PI) + 1.0) * 127.5;
+  brightness = map(brightness, 0, 255, baseBrightness / 2, baseBrightness);
+
+  leds.fill(CHSV(hue, 255, brightness));
+}
+
+static void motionKaleidoscopeFloat(LEDController& leds, const MotionData& motion, unsigned long time) {
+  float speed = 1.5 + motion.rotationNormalized * 4.0;
+  uint8_t hueBase = (uint32_t)(time / (20 / speed)) % 256;
+
+  hueBase += motion.tiltAngle;
+
+  for (uint8_t seg = 0; seg < leds.numSegments(); seg++) {
+    Segment segment = leds.getSegment(seg);
+    uint8_t hueOffset = seg * 85;
+
+    for (uint16_t pos = 0; pos < segment.length; pos++) {
+      float normalizedPos = (float)pos / segment.length;
+
+      float wave1 = sin(normalizedPos * 4 * PI + time / 200.0);
+      float wave2 = sin(normalizedPos * 2 * PI - time / 300.0);
+
+      uint8_t brightness = ((wave1 + wave2) / 2.0 + 1.0) * 127.5;
+      brightness = brightness * (0.5 + motion.shakeNormalized * 0.5);
+
+      uint8_t hue = (uint8_t)(int)(hueBase + hueOffset + (normalizedPos * 60));
+
+      leds.setSegmentPixel(seg, pos, CHSV(hue, 255, brightness));
+    }
+  }
+}
+
+// Float Goertzel bank with MotionSpectrum's bins, high-pass and block size
+struct FloatSpectrum {
+  float s1[SPECTRUM_AXES][SPECTRUM_BINS];
+  float s2[SPECTRUM_AXES][SPECTRUM_BINS];
+  float gravity[SPECTRUM_AXES];
+  float coeffs[SPECTRUM_BINS];
+  int count;
+  uint8_t levels[SPECTRUM_BINS];
+
+  void begin() {
+    memset(this, 0, sizeof(*this));
+    for (int bin = 0; bin < SPECTRUM_BINS; bin++) {
+      coeffs[bin] = 2 * cos(2 * PI * MotionSpectrum::binFrequency(bin) / MPU_UPDATE_RATE);
+    }
+  }
+
+  bool add(int16_t x, int16_t y) {
+    float input[SPECTRUM_AXES] = { (float)x, (float)y };
+    for (int axis = 0; axis < SPECTRUM_AXES; axis++) {
+      gravity[axis] += (input[axis] - gravity[axis]) / 64;
+      float v = input[axis] - gravity[axis];
+      for (int bin = 0; bin < SPECTRUM_BINS; bin++) {
+        float s0 = v + coeffs[bin] * s1[axis][bin] - s2[axis][bin];
+        s2[axis][bin] = s1[axis][bin];
+        s1[axis][bin] = s0;
+      }
+    }
+    if (++count < SPECTRUM_BLOCK) return false;
+
+    for (int bin = 0; bin < SPECTRUM_BINS; bin++) {
+      float power = 0;
+      for (int axis = 0; axis < SPECTRUM_AXES; axis++) {
+        float a = s1[axis][bin], b = s2[axis][bin];
+        power += a * a + b * b - coeffs[bin] * a * b;
+      }
+      float level = 2.0 * sqrt(power > 0 ? power : 0) / SPECTRUM_BLOCK * 255 / SPECTRUM_FULL_SCALE_MG;
+      levels[bin] = level > 255 ? 255 : (uint8_t)level;
+    }
+    memset(s1, 0, sizeof(s1));
+    memset(s2, 0, sizeof(s2));
+    count = 0;
+    return true;
+  }
+};
+
+// === Comparison harness ===
+
+struct KernelResult {
+  uint64_t referenceCycles;
+  uint64_t fixedCycles;
+  int maxError;
+  double meanError;
+  unsigned long calls;
+};
+
+static void compareFrames(const LEDController& a, const LEDController& b, KernelResult& r) {
+  for (uint16_t i = 0; i < a.numLeds(); i++) {
+    CRGB pa = a.getPixel(i);
+    CRGB pb = b.getPixel(i);
+    for (uint8_t c = 0; c < 3; c++) {
+      int diff = abs((int)pa[c] - (int)pb[c]);
+      if (diff > r.maxError) r.maxError = diff;
+      r.meanError += diff;
+    }
+  }
+}
+
+static LEDController animLeds;
+static Animations animations(animLeds);
+
+// Runs one kernel pair for each sweep step. `reference` draws input index i
+// into its own controller, `fixed` draws the same frame through Animations.
+template <typename Ref, typename Fix>
+static KernelResult runKernel(unsigned long iterations, Ref reference, Fix fixed) {
+  static LEDController refLeds;
+  KernelResult r = { 0, 0, 0, 0.0, 0 };
+
+  for (unsigned long i = 0; i < iterations; i++) {
+    uint64_t start = cycles();
+    reference(refLeds, i);
+    uint64_t mid = cycles();
+    fixed(i);
+    uint64_t end = cycles();
+
+    r.referenceCycles += mid - start;
+    r.fixedCycles += end - mid;
+    compareFrames(refLeds, animLeds, r);
+    r.calls++;
+  }
+
+  r.meanError /= (double)r.calls * NUM_LEDS * 3;
+  return r;
+}
+
+static MotionData sweepMotion(unsigned long i) {
+  MotionData m;
+  memset(&m, 0, sizeof(m));
+  m.rotationNormalized = (i % 11) / 10.0f;
+  m.shakeNormalized = (i % 7) / 6.0f;
+  m.tiltNormalized = (i % 5) / 4.0f;
+  m.tiltAngle = (i % 90);
+  return m;
+}
+
+// Cycles per sensor update through the Goertzel bank; errors are in
+// level units (0-255) over the bins of every completed block
+static KernelResult runSpectrum(unsigned long iterations) {
+  static FloatSpectrum reference;
+  static MotionSpectrum spectrum;
+  reference.begin();
+  KernelResult r = { 0, 0, 0, 0.0, 0 };
+  unsigned long blocks = 0;
+
+  for (unsigned long i = 0; i < iterations * SPECTRUM_BLOCK; i++) {
+    // A sway with a buzz on top, drifting in frequency and level
+    float t = i / (float)MPU_UPDATE_RATE;
+    int16_t x = 300 + (200 + i % 700) * sin(2 * PI * (0.7 + (i / 900) % 5) * t) + 80 * sin(2 * PI * 11 * t);
+    int16_t y = -150 + 250 * cos(2 * PI * 1.3 * t);
+
+    uint64_t start = cycles();
+    bool referenceDone = reference.add(x, y);
+    uint64_t mid = cycles();
+    bool done = spectrum.add(x, y);
+    uint64_t end = cycles();
+
+    r.referenceCycles += mid - start;
+    r.fixedCycles += end - mid;
+    r.calls++;
+
+    if (done && referenceDone) {
+      for (uint8_t bin = 0; bin < SPECTRUM_BINS; bin++) {
+        int diff = abs((int)reference.levels[bin] - (int)spectrum.level(bin));
+        if (diff > r.maxError) r.maxError = diff;
+        r.meanError += diff;
+      }
+      blocks++;
+    }
+  }
+
+  r.meanError /= blocks > 0 ? (double)blocks * SPECTRUM_BINS : 1.0;
+  return r;
+}
+
+static void report(const char* name, const KernelResult& r) {
+  double ref = (double)r.referenceCycles / r.calls;
+  double fix = (double)r.fixedCycles / r.calls;
+  printf("%-20s %12.0f %12.0f %8.2fx %9d %10.3f\n",
+         name, ref, fix, fix > 0 ? ref / fix : 0.0, r.maxError, r.meanError);
+}
+
+int main(int argc, char** argv) {
+  unsigned long iterations = 2000;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "--iterations")) iterations = strtoul(argv[i + 1], nullptr, 10);
+  }
+
+  HardwareSerial::echo = false;
+
+  printf("%-20s %12s %12s %9s %9s %10s\n",
+         "kernel", "float_cyc", "fixed_cyc", "speedup", "max_err", "mean_err");
+
+  report("wave", runKernel(iterations,
+    [](LEDController& l, unsigned long i) { waveFloat(l, i * 7, 10 + i % 21, i * 0.37f); },
+    [](unsigned long i) { animations.wave(i * 7, 10 + i % 21, i * 0.37f); }));
+
+  report("gradient", runKernel(iterations,
+    [](LEDController& l, unsigned long i) {
+      gradientFloat(l, CRGB::Red, CRGB::Blue, CRGB(20, 200, 90), (i % 500) / 500.0f);
+    },
+    [](unsigned long i) {
+      animations.gradient(CRGB::Red, CRGB::Blue, CRGB(20, 200, 90), (i % 500) / 500.0f);
+    }));
+
+  report("pulse", runKernel(iterations,
+    [](LEDController& l, unsigned long i) { pulseFloat(l, CRGB(200, 40, 90), i * 0.013f); },
+    [](unsigned long i) { animations.pulse(CRGB(200, 40, 90), i * 0.013f); }));
+
+  report("motionPulse", runKernel(iterations,
+    [](LEDController& l, unsigned long i) { motionPulseFloat(l, sweepMotion(i), i * 8); },
+    [](unsigned long i) { animations.motionPulse(sweepMotion(i), i * 8); }));
+
+  report("motionKaleidoscope", runKernel(iterations,
+    [](LEDController& l, unsigned long i) { motionKaleidoscopeFloat(l, sweepMotion(i), i * 8); },
+    [](unsigned long i) { animations.motionKaleidoscope(sweepMotion(i), i * 8); }));
+
+  // Reduced quality tiers against the same full-resolution reference
+  animations.setQuality(QUALITY_HALF);
+  report("kaleidoscope half", runKernel(iterations,
+    [](LEDController& l, unsigned long i) { motionKaleidoscopeFloat(l, sweepMotion(i), i * 8); },
+    [](unsigned long i) { animations.motionKaleidoscope(sweepMotion(i), i * 8); }));
+
+  animations.setQuality(QUALITY_QUARTER);
+  report("kaleidoscope quarter", runKernel(iterations,
+    [](LEDController& l, unsigned long i) { motionKaleidoscopeFloat(l, sweepMotion(i), i * 8); },
+    [](unsigned long i) { animations.motionKaleidoscope(sweepMotion(i), i * 8); }));
+  animations.setQuality(QUALITY_FULL);
+
+  report("spectrum update", runSpectrum(iterations / 100 > 0 ? iterations / 100 : 1));
+
+  return 0;
+}
@@ -0,0 +1,208 @@
+/*
+ * Parallel output waveform check
+ *
+ * Sends rendered frames through ParallelLEDOutput (LED_PARALLEL_OUTPUT)
+ * with the host port-write hook attached, and splits the captured port
+ * writes into one waveform per pin. Each lane is then decoded like a
+ * WS2812 would decode it: a high time of at least half way between T0H
+ * and T1H is a 1. The tool checks the pixels against the segment that
+ * lane should carry and reports high times, bit period, the longest low
+ * gap and the wire time. It exits non-zero if any lane decodes wrong or
+ * a gap would latch the strip early.
+ *
+ * Usage: parallel_capture [--vcd FILE]   (FILE: the last frame, for GTKWave)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "Config.h"
+#include "LEDController.h"
+#include "Animations.h"
+#include "ParallelLEDOutput.h"
+
+struct PortWrite {
+  uint32_t cycle;
+  uint8_t value;
+};
+
+static std::vector<PortWrite> capture;
+
+static void recordWrite(uint32_t cycle, uint8_t value) {
+  PortWrite w = { cycle, value };
+  capture.push_back(w);
+}
+
+static double cyclesToMicros(uint32_t cycles) {
+  return cycles * 1e6 / F_CPU;
+}
+
+struct LaneReport {
+  uint32_t bits;
+  uint32_t mismatches;        // Decoded bytes that differ from the segment
+  uint32_t minHigh0, maxHigh0;
+  uint32_t minHigh1, maxHigh1;
+  uint32_t minPeriod;         // Rising edge to rising edge inside a pixel
+  uint32_t maxLow;            // Longest low stretch between bits
+};
+
+// Decode one lane's bit stream and compare it with the bytes it should carry
+static LaneReport decodeLane(uint8_t lane, const std::vector<uint8_t>& expected) {
+  LaneReport r = { 0, 0, 0xFFFFFFFF, 0, 0xFFFFFFFF, 0, 0xFFFFFFFF, 0 };
+  uint8_t mask = 1 << lane;
+  bool level = false;
+  uint32_t riseAt = 0, fallAt = 0, lastRise = 0;
+  bool seenRise = false;
+  uint8_t byte = 0;
+  uint8_t bitCount = 0;
+  size_t byteIndex = 0;
+
+  for (const PortWrite& w : capture) {
+    bool high = w.value & mask;
+    if (high == level) continue;
+    level = high;
+
+    if (high) {
+      if (seenRise) {
+        uint32_t period = w.cycle - lastRise;
+        uint32_t low = w.cycle - fallAt;
+        if (period < r.minPeriod) r.minPeriod = period;
+        if (low > r.maxLow) r.maxLow = low;
+      }
+      riseAt = lastRise = w.cycle;
+      seenRise = true;
+      continue;
+    }
+
+    fallAt = w.cycle;
+    uint32_t highTime = fallAt - riseAt;
+    bool one = highTime * 2 >= PARALLEL_T0H_CYCLES + PARALLEL_T1H_CYCLES;
+    if (one) {
+      if (highTime < r.minHigh1) r.minHigh1 = highTime;
+      if (highTime > r.maxHigh1) r.maxHigh1 = highTime;
+    } else {
+      if (highTime < r.minHigh0) r.minHigh0 = highTime;
+      if (highTime > r.maxHigh0) r.maxHigh0 = highTime;
+    }
+
+    byte = (byte << 1) | one;
+    r.bits++;
+    if (++bitCount == 8) {
+      if (byteIndex >= expected.size() || expected[byteIndex] != byte) r.mismatches++;
+      byteIndex++;
+      byte = 0;
+      bitCount = 0;
+    }
+  }
+
+  if (byteIndex != expected.size() || bitCount != 0) r.mismatches++;
+  return r;
+}
+
+// What lane n should send: its segment in buffer order (G, R, B, scaled),
+// padded with black to the longest segment
+static std::vector<uint8_t> expectedLane(uint8_t lane, const CRGB* leds, uint8_t brightness) {
+  std::vector<uint8_t> bytes;
+  for (uint16_t p = 0; p < SegmentLayout::maxLength(); p++) {
+    CRGB c = p < SegmentLayout::length(lane) ? leds[SegmentLayout::start(lane) + p] : CRGB::Black;
+    bytes.push_back(scale8(c.g, brightness));
+    bytes.push_back(scale8(c.r, brightness));
+    bytes.push_back(scale8(c.b, brightness));
+  }
+  return bytes;
+}
+
+static void writeVcd(const char* path) {
+  FILE* f = fopen(path, "w");
+  if (!f) {
+    perror(path);
+    return;
+  }
+
+  // 1 cycle at 16 MHz = 62.5 ns = 625 x 100 ps
+  fprintf(f, "$timescale 100ps $end\n$scope module parallel $end\n");
+  for (uint8_t lane = 0; lane < NUM_SEGMENTS; lane++) {
+    fprintf(f, "$var wire 1 %c lane%u $end\n", '!' + lane, lane);
+  }
+  fprintf(f, "$upscope $end\n$enddefinitions $end\n");
+
+  uint8_t previous = 0xFF;
+  for (const PortWrite& w : capture) {
+    fprintf(f, "#%llu\n", (unsigned long long)w.cycle * 625);
+    for (uint8_t lane = 0; lane < NUM_SEGMENTS; lane++) {
+      uint8_t mask = 1 << lane;
+      if ((w.value ^ previous) & mask) fprintf(f, "%d%c\n", (w.value & mask) ? 1 : 0, '!' + lane);
+    }
+    previous = w.value;
+  }
+  fclose(f);
+}
+
+static LEDController leds;
+static Animations animations(leds);
+static ParallelLEDOutput output;
+
+int main(int argc, char** argv) {
+  const char* vcdPath = nullptr;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "--vcd")) vcdPath = argv[i + 1];
+  }
+
+  HardwareSerial::echo = false;
+  ParallelLEDOutput::setPortWriteHook(recordWrite);
+  output.begin();
+
+  MotionData motion;
+  memset(&motion, 0, sizeof(motion));
+  motion.rotationNormalized = 0.4;
+  motion.shakeNormalized = 0.7;
+
+  printf("%-12s %-6s %7s %9s %9s %9s %9s %9s %6s\n",
+         "frame", "lane", "bits", "t0h_ns", "t1h_ns", "bit_ns", "gap_us", "wire_us", "errors");
+
+  bool ok = true;
+  for (int frame = 0; frame < 3; frame++) {
+    const char* name;
+    uint8_t brightness = 255;
+    if (frame == 0) {
+      // Every pixel distinct, so any lane or position mix-up shows
+      name = "index";
+      CRGB* pixels = leds.pixels();
+      for (uint16_t i = 0; i < NUM_LEDS; i++) {
+        pixels[i] = CRGB(i & 0xFF, (i * 7) & 0xFF, 255 - (i & 0xFF));
+      }
+    } else if (frame == 1) {
+      name = "kaleidoscope";
+      animations.motionKaleidoscope(motion, 12345);
+    } else {
+      name = "dimmed";
+      brightness = 40;
+      animations.motionKaleidoscope(motion, 23456);
+    }
+
+    capture.clear();
+    output.show(leds.pixels(), brightness);
+    uint32_t wireCycles = capture.empty() ? 0 : capture.back().cycle;
+
+    for (uint8_t lane = 0; lane < NUM_SEGMENTS; lane++) {
+      LaneReport r = decodeLane(lane, expectedLane(lane, leds.pixels(), brightness));
+      bool gapOk = cyclesToMicros(r.maxLow) < WS2812_LATCH_US / 2;
+      if (r.mismatches || !gapOk) ok = false;
+
+      printf("%-12s %-6u %7u %4.0f-%-4.0f %4.0f-%-4.0f %9.0f %9.1f %9.0f %6u%s\n",
+             name, lane, r.bits,
+             cyclesToMicros(r.minHigh0) * 1000, cyclesToMicros(r.maxHigh0) * 1000,
+             cyclesToMicros(r.minHigh1) * 1000, cyclesToMicros(r.maxHigh1) * 1000,
+             cyclesToMicros(r.minPeriod) * 1000, cyclesToMicros(r.maxLow),
+             cyclesToMicros(wireCycles), r.mismatches, gapOk ? "" : " (gap would latch)");
+    }
+  }
+
+  printf("\nparallel wire time %lu us per frame, serial %lu us\n",
+         ParallelLEDOutput::frameMicros(), (unsigned long)NUM_LEDS * 30);
+
+  if (vcdPath) writeVcd(vcdPath);
+  return ok ? 0 : 1;
+}
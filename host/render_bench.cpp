@@ -0,0 +1,427 @@
+/*
+ * Headless frame renderer and benchmark driver
+ *
+ * Builds the sketch's LEDController, Animations and MotionProcessor against
+ * the stand-ins in host/stubs, replays a motion trace through every registered
+ * mode and reports per-mode render time and a frame checksum. Frames can be
+ * dumped as PPM (one row per frame) or raw RGB for inspection.
+ *
+ * Usage: render_bench [options]
+ *   --frames N            frames per run (default 600, 5 s at TARGET_FPS)
+ *   --trace FILE          replay a recorded CSV trace instead of the synthetic set
+ *   --traces a,b,...      synthetic traces to run (still,tilt,spin,shake,mixed)
+ *   --mode NAME           run a single mode
+ *   --seed N              PRNG seed (default 1)
+ *   --dump DIR            write one image per trace/mode into DIR
+ *   --format ppm|raw      dump format (default ppm)
+ *   --baseline FILE       compare checksums against FILE, exit 1 on mismatch
+ *   --write-baseline FILE save checksums to FILE
+ *   --verbose             echo Serial output to stderr
+ *
+ * Trace CSV columns: t_ms,ax,ay,az,gx,gy,gz (m/s^2 and rad/s, as reported by
+ * Adafruit_MPU6050). Lines starting with '#' are ignored.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "Config.h"
+#include "LEDController.h"
+#include "Animations.h"
+#include "AnimationRegistry.h"
+#include "MotionProcessor.h"
+#include "FastRandom.h"
+#include <Adafruit_MPU6050.h>  // hostSetMotionSample(); traces only reach the Adafruit path
+
+// Every registered mode, then Fire -> Kaleidoscope transitions looping
+// over TRANSITION_DURATION_MS (as renderFrame() in kaleidoscope.ino)
+struct BenchMode {
+  const char* name;
+  bool transition;
+  TransitionStyle style;
+};
+
+static std::vector<BenchMode> benchModes() {
+  std::vector<BenchMode> modes;
+  for (uint8_t m = 0; m < AnimationRegistry::count(); m++) {
+    modes.push_back({ AnimationRegistry::name(m), false, TRANSITION_CROSSFADE });
+  }
+  modes.push_back({ "Crossfade", true, TRANSITION_CROSSFADE });
+  modes.push_back({ "Additive", true, TRANSITION_ADDITIVE });
+  modes.push_back({ "Wipe", true, TRANSITION_WIPE });
+  return modes;
+}
+
+struct TraceSample {
+  unsigned long timeMs;
+  HostMotionSample sample;
+};
+
+struct Trace {
+  std::string name;
+  std::vector<TraceSample> samples;  // empty for synthetic traces
+};
+
+struct RunResult {
+  std::string trace;
+  std::string mode;
+  unsigned long frames;
+  unsigned long sent;  // Frames show() transmitted (the rest were unchanged)
+  double avgUs;
+  double maxUs;
+  double totalMs;
+  uint32_t checksum;
+};
+
+static const float GRAVITY = 9.81f;
+
+// Synthetic motion, in the units Adafruit_MPU6050 reports
+static HostMotionSample syntheticSample(const std::string& name, unsigned long t) {
+  HostMotionSample s = { 0, 0, GRAVITY, 0, 0, 0, 25.0f };
+  double sec = t / 1000.0;
+
+  if (name == "tilt") {
+    // Slow +-40 degree nod with a gentle side-to-side lean
+    double pitch = 40.0 * sin(2 * PI * sec / 4.0) * PI / 180.0;
+    double roll = 20.0 * sin(2 * PI * sec / 6.0) * PI / 180.0;
+    s.accelY = GRAVITY * sin(pitch);
+    s.accelX = -GRAVITY * cos(pitch) * sin(roll);
+    s.accelZ = GRAVITY * cos(pitch) * cos(roll);
+    s.gyroX = 40.0 * (2 * PI / 4.0) * cos(2 * PI * sec / 4.0) * PI / 180.0;
+  } else if (name == "spin") {
+    // Pan ramping up to ~340 deg/s and back down
+    s.gyroZ = 6.0 * sin(PI * fmod(sec, 5.0) / 5.0);
+  } else if (name == "shake") {
+    // 12 Hz buzz in one-second bursts
+    double envelope = fmod(sec, 2.0) < 1.0 ? 1.0 : 0.1;
+    s.accelX = envelope * 8.0 * sin(2 * PI * 12.0 * sec);
+    s.accelZ = GRAVITY + envelope * 6.0 * cos(2 * PI * 12.0 * sec);
+  } else if (name == "mixed") {
+    HostMotionSample tilt = syntheticSample("tilt", t);
+    HostMotionSample spin = syntheticSample("spin", t);
+    HostMotionSample shake = syntheticSample("shake", t);
+    s = tilt;
+    s.gyroZ = spin.gyroZ;
+    s.accelX += shake.accelX * 0.5f;
+    s.accelZ += (shake.accelZ - GRAVITY) * 0.5f;
+  }
+
+  return s;
+}
+
+static HostMotionSample traceSample(const Trace& trace, unsigned long t) {
+  if (trace.samples.empty()) {
+    return syntheticSample(trace.name, t);
+  }
+
+  // Hold the most recent sample, like a sensor polled between updates
+  const TraceSample* current = &trace.samples[0];
+  for (const TraceSample& s : trace.samples) {
+    if (s.timeMs > t) break;
+    current = &s;
+  }
+  return current->sample;
+}
+
+static bool loadTrace(const char* path, Trace& trace) {
+  FILE* f = fopen(path, "r");
+  if (!f) {
+    fprintf(stderr, "cannot open trace %s\n", path);
+    return false;
+  }
+
+  char line[256];
+  while (fgets(line, sizeof(line), f)) {
+    if (line[0] == '#' || line[0] == '\n') continue;
+
+    TraceSample ts;
+    ts.sample.temp = 25.0f;
+    if (sscanf(line, "%lu,%f,%f,%f,%f,%f,%f", &ts.timeMs,
+               &ts.sample.accelX, &ts.sample.accelY, &ts.sample.accelZ,
+               &ts.sample.gyroX, &ts.sample.gyroY, &ts.sample.gyroZ) == 7) {
+      trace.samples.push_back(ts);
+    }
+  }
+  fclose(f);
+
+  const char* base = strrchr(path, '/');
+  trace.name = base ? base + 1 : path;
+  if (trace.samples.empty()) {
+    fprintf(stderr, "trace %s has no samples\n", path);
+    return false;
+  }
+  return true;
+}
+
+static uint32_t fnv1a(uint32_t hash, const uint8_t* data, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    hash ^= data[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static void writeDump(const std::string& path, const std::vector<uint8_t>& pixels,
+                      unsigned long frames, bool ppm) {
+  FILE* f = fopen(path.c_str(), "wb");
+  if (!f) {
+    fprintf(stderr, "cannot write %s\n", path.c_str());
+    return;
+  }
+  if (ppm) {
+    fprintf(f, "P6\n%d %lu\n255\n", NUM_LEDS, frames);
+  }
+  fwrite(pixels.data(), 1, pixels.size(), f);
+  fclose(f);
+}
+
+static RunResult runMode(const Trace& trace, const BenchMode& mode, unsigned long frames,
+                         unsigned long seed, std::vector<uint8_t>* dump) {
+  hostSetMicros(0);
+  randomSeed(seed);
+  rngSeed(seed);
+
+  // Fresh objects per run so stateful modes (fire, twinkle) start cold
+  LEDController ledController;
+  Animations animations(ledController);
+  AnimationRegistry registry(animations);
+  MotionProcessor motionProcessor;
+
+  uint8_t outgoing = AnimationRegistry::find("Fire");
+  uint8_t incoming = AnimationRegistry::find("Kaleidoscope");
+  if (mode.transition) {
+    registry.activate(outgoing);
+    registry.activate(incoming);
+  } else {
+    incoming = AnimationRegistry::find(mode.name);
+    registry.activate(incoming);
+  }
+
+  ledController.begin();
+  motionProcessor.begin();
+  hostSetMicros(0);
+
+  RunResult result;
+  result.trace = trace.name;
+  result.mode = mode.name;
+  result.frames = 0;
+  result.sent = 0;
+  result.maxUs = 0;
+  result.totalMs = 0;
+  result.checksum = 2166136261u;
+
+  // Same polling structure as loop(), stepped one millisecond at a time
+  unsigned long lastFrame = 0;
+  unsigned long lastMotionUpdate = 0;
+  bool first = true;
+
+  while (result.frames < frames) {
+    unsigned long currentTime = millis();
+
+    if (first || currentTime - lastMotionUpdate >= (1000 / MPU_UPDATE_RATE)) {
+      hostSetMotionSample(traceSample(trace, currentTime));
+      motionProcessor.update();
+      lastMotionUpdate = currentTime;
+    }
+
+    if (first || currentTime - lastFrame >= FRAME_DELAY) {
+      unsigned long frameStart = micros();
+      MotionData motion = motionProcessor.getMotionDataAt(
+          motionProcessor.predictDisplayMicros(frameStart));
+
+      auto start = std::chrono::steady_clock::now();
+      if (mode.transition) {
+        animations.beginLayer();
+        registry.render(outgoing, motion, currentTime);
+        animations.endLayer();
+        registry.render(incoming, motion, currentTime);
+        animations.composite(mode.style, (currentTime % TRANSITION_DURATION_MS) * 255 / TRANSITION_DURATION_MS);
+      } else {
+        registry.render(incoming, motion, currentTime);
+      }
+      auto end = std::chrono::steady_clock::now();
+
+      if (ledController.show()) {
+        motionProcessor.recordFrameDisplayed(frameStart, micros() + ledController.photonDelayMicros());
+        result.sent++;
+      }
+
+      double us = std::chrono::duration<double, std::micro>(end - start).count();
+      result.totalMs += us / 1000.0;
+      if (us > result.maxUs) result.maxUs = us;
+
+      const uint8_t* frame = (const uint8_t*)FastLED.shownFrame();
+      size_t bytes = FastLED.shownCount() * sizeof(CRGB);
+      result.checksum = fnv1a(result.checksum, frame, bytes);
+      if (dump) {
+        dump->insert(dump->end(), frame, frame + bytes);
+      }
+
+      lastFrame = currentTime;
+      result.frames++;
+    }
+
+    first = false;
+    hostAdvanceMicros(1000);
+  }
+
+  result.avgUs = result.totalMs * 1000.0 / result.frames;
+  return result;
+}
+
+static std::vector<std::string> splitList(const char* list) {
+  std::vector<std::string> items;
+  std::string current;
+  for (const char* p = list; ; p++) {
+    if (*p == ',' || *p == '\0') {
+      if (!current.empty()) items.push_back(current);
+      current.clear();
+      if (*p == '\0') break;
+    } else {
+      current += *p;
+    }
+  }
+  return items;
+}
+
+static void usage() {
+  fprintf(stderr,
+          "usage: render_bench [--frames N] [--trace FILE] [--traces a,b] [--mode NAME]\n"
+          "                    [--seed N] [--dump DIR] [--format ppm|raw]\n"
+          "                    [--baseline FILE] [--write-baseline FILE] [--verbose]\n");
+}
+
+int main(int argc, char** argv) {
+  unsigned long frames = TARGET_FPS * 5;
+  unsigned long seed = 1;
+  const char* tracePath = nullptr;
+  const char* traceList = "still,tilt,spin,shake,mixed";
+  const char* onlyMode = nullptr;
+  const char* dumpDir = nullptr;
+  const char* baselinePath = nullptr;
+  const char* writeBaselinePath = nullptr;
+  bool ppm = true;
+
+  HardwareSerial::echo = false;
+
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+    if (!strcmp(arg, "--verbose")) {
+      HardwareSerial::echo = true;
+      continue;
+    }
+    if (!value) {
+      usage();
+      return 2;
+    }
+    i++;
+
+    if (!strcmp(arg, "--frames")) frames = strtoul(value, nullptr, 10);
+    else if (!strcmp(arg, "--seed")) seed = strtoul(value, nullptr, 10);
+    else if (!strcmp(arg, "--trace")) tracePath = value;
+    else if (!strcmp(arg, "--traces")) traceList = value;
+    else if (!strcmp(arg, "--mode")) onlyMode = value;
+    else if (!strcmp(arg, "--dump")) dumpDir = value;
+    else if (!strcmp(arg, "--format")) ppm = strcmp(value, "raw") != 0;
+    else if (!strcmp(arg, "--baseline")) baselinePath = value;
+    else if (!strcmp(arg, "--write-baseline")) writeBaselinePath = value;
+    else {
+      usage();
+      return 2;
+    }
+  }
+
+  if (frames == 0) {
+    usage();
+    return 2;
+  }
+
+  std::vector<Trace> traces;
+  if (tracePath) {
+    Trace trace;
+    if (!loadTrace(tracePath, trace)) return 2;
+    traces.push_back(trace);
+  } else {
+    for (const std::string& name : splitList(traceList)) {
+      Trace trace;
+      trace.name = name;
+      traces.push_back(trace);
+    }
+  }
+
+  std::vector<BenchMode> modes = benchModes();
+  std::vector<RunResult> results;
+  printf("%-12s %-13s %7s %7s %9s %9s %10s  %s\n",
+         "trace", "mode", "frames", "sent", "avg_us", "max_us", "total_ms", "checksum");
+
+  for (const Trace& trace : traces) {
+    for (size_t m = 0; m < modes.size(); m++) {
+      if (onlyMode && strcasecmp(onlyMode, modes[m].name) != 0) continue;
+
+      std::vector<uint8_t> pixels;
+      RunResult r = runMode(trace, modes[m], frames, seed, dumpDir ? &pixels : nullptr);
+      results.push_back(r);
+
+      printf("%-12s %-13s %7lu %7lu %9.2f %9.2f %10.2f  %08x\n",
+             r.trace.c_str(), r.mode.c_str(), r.frames, r.sent, r.avgUs, r.maxUs, r.totalMs, r.checksum);
+
+      if (dumpDir) {
+        std::string path = std::string(dumpDir) + "/" + r.trace + "-" + r.mode +
+                           (ppm ? ".ppm" : ".rgb");
+        writeDump(path, pixels, r.frames, ppm);
+      }
+    }
+  }
+
+  if (writeBaselinePath) {
+    FILE* f = fopen(writeBaselinePath, "w");
+    if (!f) {
+      fprintf(stderr, "cannot write %s\n", writeBaselinePath);
+      return 2;
+    }
+    fprintf(f, "# trace mode frames seed checksum\n");
+    for (const RunResult& r : results) {
+      fprintf(f, "%s %s %lu %lu %08x\n", r.trace.c_str(), r.mode.c_str(), r.frames, seed, r.checksum);
+    }
+    fclose(f);
+  }
+
+  int mismatches = 0;
+  if (baselinePath) {
+    FILE* f = fopen(baselinePath, "r");
+    if (!f) {
+      fprintf(stderr, "cannot open baseline %s\n", baselinePath);
+      return 2;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+      char traceName[64], modeName[64];
+      unsigned long baseFrames, baseSeed;
+      unsigned int checksum;
+      if (line[0] == '#') continue;
+      if (sscanf(line, "%63s %63s %lu %lu %x", traceName, modeName, &baseFrames, &baseSeed, &checksum) != 5) {
+        continue;
+      }
+      for (const RunResult& r : results) {
+        if (r.trace == traceName && r.mode == modeName) {
+          if (baseFrames != r.frames || baseSeed != seed) {
+            printf("SKIP     %s/%s: baseline recorded with different frames/seed\n", traceName, modeName);
+          } else if (checksum != r.checksum) {
+            printf("MISMATCH %s/%s: expected %08x got %08x\n", traceName, modeName, checksum, r.checksum);
+            mismatches++;
+          }
+        }
+      }
+    }
+    fclose(f);
+    printf("%d checksum mismatch(es)\n", mismatches);
+  }
+
+  return mismatches ? 1 : 0;
+}
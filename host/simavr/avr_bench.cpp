@@ -0,0 +1,543 @@
+/*
+ * Cycle-exact firmware benchmark under simavr
+ *
+ * Runs the real kaleidoscope.ino image (built with PROFILER_MARKERS=1, see
+ * the Makefile) on a simulated ATmega2560 and attaches three models to it:
+ *
+ *   MPU6050   An I2C device at 0x68 with a register file. Reads of the
+ *             sensor block (0x3B-0x48) return the motion trace at the
+ *             current simulated time, scaled by the configured ranges.
+ *   WS2812    A decoder on pin 4 (PG5) that turns the data line back into
+ *             frames: a high time over WS2812_ONE_CYCLES is a 1, and a low
+ *             stretch over WS2812_RESET_CYCLES ends a frame. With
+ *             --parallel (firmware built with LED_PARALLEL_OUTPUT=1) there
+ *             is one decoder per segment on PORTA bits 0-2 instead.
+ *   Markers   The FrameProfiler writes frame and stage codes to PORTL.
+ *             Each change is stamped with the CPU cycle count.
+ *
+ * Each mode runs for --frames measured frames after --settle frames, which
+ * skips the transition. The harness then sends 'm' on the serial port to
+ * switch modes, and stops when the first mode comes round again. It
+ * reports cycles per stage and per frame for every mode. Frame cycles
+ * are render plus show; the sensor task runs between frames, so it is
+ * reported per run in its own column and kept out of the frame total. It exits non-zero
+ * if more than --max-miss-percent of a mode's frames take longer than one
+ * 120 FPS period (F_CPU / TARGET_FPS cycles). Each data line also gets
+ * its measured waveform: high times for 0 and 1 bits, the longest low
+ * stretch inside a frame (the gap between parallel pixels), and the wire
+ * time from a frame's first rising edge to its last falling edge.
+ *
+ * Usage: avr_bench [--trace FILE] [--frames N] [--settle N]
+ *                  [--max-miss-percent P] [--ppm FILE] [--serial] [--parallel]
+ *                  FIRMWARE.elf
+ *
+ * Traces are the render_bench CSV format: t_ms,ax,ay,az,gx,gy,gz in m/s^2
+ * and rad/s, looped. Without one, the tube sits still for two seconds
+ * (for calibration) and then sways and turns. Only the Adafruit driver path
+ * (MPU_USE_FIFO 0) is modelled.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include <simavr/sim_avr.h>
+#include <simavr/sim_elf.h>
+#include <simavr/avr_ioport.h>
+#include <simavr/avr_twi.h>
+#include <simavr/avr_uart.h>
+
+#include "Config.h"
+#include "FrameProfiler.h"
+#include "SegmentLayout.h"
+
+#define FRAME_BUDGET_CYCLES (F_CPU / TARGET_FPS)
+#define WS2812_ONE_CYCLES 9        // High time (562 ns) separating 0 from 1
+#define WS2812_RESET_CYCLES 800    // 50 us low ends a frame
+#define MPU_ADDRESS 0x68
+#define MAX_MODES 64
+
+static const char* const stageNames[STAGE_COUNT] = { "sensor", "render", "show" };
+
+static double cyclesToMillis(avr_cycle_count_t cycles) {
+  return cycles * 1000.0 / F_CPU;
+}
+
+static double cyclesToMicros(unsigned long cycles) {
+  return cycles * 1e6 / F_CPU;
+}
+
+// ---- Motion trace ----
+
+struct TraceRow {
+  double t;  // ms
+  double ax, ay, az, gx, gy, gz;
+};
+
+static std::vector<TraceRow> trace;
+
+static bool loadTrace(const char* path) {
+  FILE* f = fopen(path, "r");
+  if (!f) {
+    perror(path);
+    return false;
+  }
+  char line[256];
+  while (fgets(line, sizeof(line), f)) {
+    TraceRow r;
+    if (sscanf(line, "%lf,%lf,%lf,%lf,%lf,%lf,%lf", &r.t, &r.ax, &r.ay, &r.az, &r.gx, &r.gy, &r.gz) == 7) {
+      trace.push_back(r);
+    }
+  }
+  fclose(f);
+  return !trace.empty();
+}
+
+// Still for calibration, then a slow sway with a turn and bursts of shake
+static void builtInTrace() {
+  for (int ms = 0; ms < 20000; ms += 5) {
+    TraceRow r = { (double)ms, 0, 0, 9.81, 0, 0, 0 };
+    if (ms >= 2000) {
+      double s = (ms - 2000) / 1000.0;
+      double tilt = 0.35 * sin(s * 2 * M_PI * 0.4);
+      r.ax = 9.81 * sin(tilt);
+      r.az = 9.81 * cos(tilt);
+      r.gy = 0.35 * 2 * M_PI * 0.4 * cos(s * 2 * M_PI * 0.4);
+      r.gz = 1.2 * sin(s * 2 * M_PI * 0.1);
+      if (((ms / 1000) % 5) == 4) r.ay = 6.0 * sin(s * 2 * M_PI * 6);
+    }
+    trace.push_back(r);
+  }
+}
+
+static const TraceRow& traceAt(double ms) {
+  double span = trace.back().t + 1;
+  double t = fmod(ms, span);
+  size_t lo = 0, hi = trace.size() - 1;
+  while (lo < hi) {
+    size_t mid = (lo + hi + 1) / 2;
+    if (trace[mid].t <= t) lo = mid;
+    else hi = mid - 1;
+  }
+  return trace[lo];
+}
+
+// ---- MPU6050 on the TWI bus ----
+
+struct Mpu6050 {
+  avr_t* avr;
+  avr_irq_t* irq;   // TWI_IRQ_INPUT / TWI_IRQ_OUTPUT pair
+  uint8_t regs[128];
+  uint8_t pointer;
+  bool selected;
+  bool expectRegister;
+};
+
+static const char* mpuIrqNames[2] = { "8>mpu6050.out", "32<mpu6050.in" };
+
+static void putWord(uint8_t* at, int32_t value) {
+  if (value > 32767) value = 32767;
+  if (value < -32768) value = -32768;
+  at[0] = (uint16_t)value >> 8;
+  at[1] = value & 0xFF;
+}
+
+// Latch the trace into the sensor registers, as the chip does per sample
+static void mpuSample(Mpu6050* m) {
+  const TraceRow& r = traceAt(cyclesToMillis(m->avr->cycle));
+  double accelLsb = 16384.0 / (1 << ((m->regs[0x1C] >> 3) & 3));  // per g
+  double gyroLsb = 131.0 / (1 << ((m->regs[0x1B] >> 3) & 3));     // per deg/s
+  const double g = 9.80665, degrees = 180.0 / M_PI;
+
+  putWord(&m->regs[0x3B], lround(r.ax / g * accelLsb));
+  putWord(&m->regs[0x3D], lround(r.ay / g * accelLsb));
+  putWord(&m->regs[0x3F], lround(r.az / g * accelLsb));
+  putWord(&m->regs[0x41], lround((25.0 - 36.53) * 340));
+  putWord(&m->regs[0x43], lround(r.gx * degrees * gyroLsb));
+  putWord(&m->regs[0x45], lround(r.gy * degrees * gyroLsb));
+  putWord(&m->regs[0x47], lround(r.gz * degrees * gyroLsb));
+}
+
+static void mpuBusHook(avr_irq_t* irq, uint32_t value, void* param) {
+  Mpu6050* m = (Mpu6050*)param;
+  avr_twi_msg_irq_t v;
+  v.u.v = value;
+
+  if (v.u.twi.msg & TWI_COND_STOP) m->selected = false;
+
+  if (v.u.twi.msg & TWI_COND_START) {
+    m->selected = (v.u.twi.addr >> 1) == MPU_ADDRESS;
+    if (m->selected) {
+      bool read = v.u.twi.addr & 1;
+      m->expectRegister = !read;
+      if (read) mpuSample(m);
+      avr_raise_irq(m->irq + TWI_IRQ_INPUT, avr_twi_irq_msg(TWI_COND_ACK, v.u.twi.addr, 1));
+    }
+  }
+  if (!m->selected) return;
+
+  if (v.u.twi.msg & TWI_COND_WRITE) {
+    avr_raise_irq(m->irq + TWI_IRQ_INPUT, avr_twi_irq_msg(TWI_COND_ACK, v.u.twi.addr, 1));
+    if (m->expectRegister) {
+      m->pointer = v.u.twi.data & 0x7F;
+      m->expectRegister = false;
+    } else {
+      uint8_t data = v.u.twi.data;
+      if (m->pointer == 0x6B) data &= ~0x80;  // Device reset completes at once
+      m->regs[m->pointer] = data;
+      m->pointer = (m->pointer + 1) & 0x7F;
+    }
+  }
+
+  if (v.u.twi.msg & TWI_COND_READ) {
+    avr_raise_irq(m->irq + TWI_IRQ_INPUT, avr_twi_irq_msg(TWI_COND_READ, v.u.twi.addr, m->regs[m->pointer]));
+    m->pointer = (m->pointer + 1) & 0x7F;
+  }
+}
+
+static void mpuAttach(avr_t* avr, Mpu6050* m) {
+  memset(m, 0, sizeof(*m));
+  m->avr = avr;
+  m->regs[0x75] = MPU_ADDRESS;  // WHO_AM_I
+  m->regs[0x6B] = 0x40;         // Asleep after power-up
+  m->irq = avr_alloc_irq(&avr->irq_pool, 0, 2, mpuIrqNames);
+  avr_irq_register_notify(m->irq + TWI_IRQ_OUTPUT, mpuBusHook, m);
+  avr_connect_irq(m->irq + TWI_IRQ_INPUT, avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_INPUT));
+  avr_connect_irq(avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_OUTPUT), m->irq + TWI_IRQ_OUTPUT);
+}
+
+// ---- WS2812 data lines ----
+
+struct CycleStats {
+  unsigned long long total;
+  unsigned long count;
+  unsigned long min;
+  unsigned long max;
+
+  void add(unsigned long cycles) {
+    if (count == 0 || cycles < min) min = cycles;
+    if (cycles > max) max = cycles;
+    total += cycles;
+    count++;
+  }
+  unsigned long average() const { return count ? total / count : 0; }
+};
+
+
+struct StripDecoder {
+  avr_t* avr;
+  const char* name;
+  size_t frameBytes;           // What a complete frame carries
+  avr_cycle_count_t riseAt;
+  avr_cycle_count_t fallAt;
+  avr_cycle_count_t frameStart;
+  uint8_t byte;
+  uint8_t bitCount;
+  std::vector<uint8_t> frame;  // GRB as sent
+  unsigned long frames;
+  unsigned long shortFrames;   // Latched with fewer than frameBytes
+  std::vector<uint8_t> rgb;    // Captured frames for --ppm
+  bool keep;
+  CycleStats high0, high1;     // High time of 0 and 1 bits
+  CycleStats gap;              // Low stretches inside a frame
+  CycleStats wire;             // First rise to last fall, per frame
+};
+
+static void stripFinishFrame(StripDecoder* s) {
+  if (s->frame.empty()) return;
+  s->frames++;
+  if (s->frame.size() < s->frameBytes) s->shortFrames++;
+  s->wire.add(s->fallAt - s->frameStart);
+  if (s->keep) {
+    for (int i = 0; i < NUM_LEDS; i++) {
+      size_t at = i * 3;
+      bool have = at + 2 < s->frame.size();
+      s->rgb.push_back(have ? s->frame[at + 1] : 0);
+      s->rgb.push_back(have ? s->frame[at] : 0);
+      s->rgb.push_back(have ? s->frame[at + 2] : 0);
+    }
+  }
+  s->frame.clear();
+  s->bitCount = 0;
+}
+
+static void stripPinHook(avr_irq_t* irq, uint32_t value, void* param) {
+  StripDecoder* s = (StripDecoder*)param;
+  avr_cycle_count_t now = s->avr->cycle;
+
+  if (value) {
+    if (now - s->fallAt > WS2812_RESET_CYCLES) {
+      stripFinishFrame(s);
+      s->frameStart = now;
+    } else {
+      s->gap.add(now - s->fallAt);
+    }
+    s->riseAt = now;
+    return;
+  }
+
+  s->fallAt = now;
+  unsigned long high = now - s->riseAt;
+  bool one = high > WS2812_ONE_CYCLES;
+  (one ? s->high1 : s->high0).add(high);
+  s->byte = (s->byte << 1) | one;
+  if (++s->bitCount == 8) {
+    s->frame.push_back(s->byte);
+    s->bitCount = 0;
+  }
+}
+
+// ---- Profiler markers ----
+
+struct ModeBench {
+  CycleStats stages[STAGE_COUNT];
+  CycleStats frame;          // Stage work inside the frame: render and show
+  unsigned long overBudget;
+  unsigned long framesSeen;  // Measured or settling
+};
+
+struct MarkerState {
+  avr_t* avr;
+  ModeBench modes[MAX_MODES];
+  int mode;                  // -1 until the first frame
+  int firstMode;
+  bool switched;             // Left the first mode at least once
+  avr_cycle_count_t stageStart[STAGE_COUNT];
+  unsigned long stageCycles[STAGE_COUNT];  // Since the last frame marker
+  unsigned long frameWork;
+  bool inFrame;                // Between a frame marker and its end
+  unsigned long settle;
+  unsigned long framesPerMode;
+  bool requestSwitch;
+  bool done;
+};
+
+static void markerHook(avr_irq_t* irq, uint32_t value, void* param) {
+  MarkerState* s = (MarkerState*)param;
+  avr_cycle_count_t now = s->avr->cycle;
+  uint8_t code = value & 0xC0;
+  uint8_t arg = value & 0x3F;
+
+  if (code == PROFILER_MARKER_STAGE_BEGIN && arg < STAGE_COUNT) {
+    s->stageStart[arg] = now;
+  } else if (code == PROFILER_MARKER_STAGE_END && arg < STAGE_COUNT) {
+    unsigned long cycles = now - s->stageStart[arg];
+    if (s->inFrame) {
+      s->stageCycles[arg] += cycles;
+      s->frameWork += cycles;
+    } else if (s->mode >= 0) {
+      // The sensor task runs between frames: its own stage stats, per
+      // run, for the mode on screen, but not part of any frame's work
+      ModeBench& m = s->modes[s->mode];
+      if (m.framesSeen > s->settle && m.frame.count < s->framesPerMode) m.stages[arg].add(cycles);
+    }
+  } else if (code == PROFILER_MARKER_FRAME) {
+    s->inFrame = true;
+    memset(s->stageCycles, 0, sizeof(s->stageCycles));
+    s->frameWork = 0;
+    if (s->mode != arg) {
+      if (s->mode >= 0) s->switched = true;
+      if (s->firstMode < 0) s->firstMode = arg;
+      else if (s->switched && arg == s->firstMode) s->done = true;
+      s->mode = arg;
+      s->modes[arg].framesSeen = 0;
+    }
+  } else if (value == PROFILER_MARKER_FRAME_END && s->mode >= 0) {
+    ModeBench& m = s->modes[s->mode];
+    if (++m.framesSeen > s->settle && m.frame.count < s->framesPerMode) {
+      for (int i = 0; i < STAGE_COUNT; i++) {
+        if (s->stageCycles[i]) m.stages[i].add(s->stageCycles[i]);
+      }
+      m.frame.add(s->frameWork);
+      if (s->frameWork > FRAME_BUDGET_CYCLES) m.overBudget++;
+      if (m.frame.count == s->framesPerMode) s->requestSwitch = true;
+    }
+    s->inFrame = false;
+  }
+}
+
+// ---- Serial ----
+
+static bool echoSerial = false;
+
+static void uartOutputHook(avr_irq_t* irq, uint32_t value, void* param) {
+  if (echoSerial) fputc(value, stderr);
+}
+
+static void stripAttach(avr_t* avr, StripDecoder* s, const char* name, char port, int bit, size_t frameBytes,
+                        bool keep) {
+  s->avr = avr;
+  s->name = name;
+  s->frameBytes = frameBytes;
+  s->keep = keep;
+  avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ(port), bit), stripPinHook, s);
+}
+
+static void printStrip(const StripDecoder& s) {
+  printf("%-8s %7lu %6lu %4.0f-%-4.0f %4.0f-%-4.0f %6.1f %6.1f %8.0f %8.0f\n", s.name, s.frames, s.shortFrames,
+         cyclesToMicros(s.high0.min) * 1000, cyclesToMicros(s.high0.max) * 1000,
+         cyclesToMicros(s.high1.min) * 1000, cyclesToMicros(s.high1.max) * 1000,
+         cyclesToMicros(s.gap.average()), cyclesToMicros(s.gap.max),
+         cyclesToMicros(s.wire.average()), cyclesToMicros(s.wire.max));
+}
+
+static void writePpm(const char* path, const StripDecoder& strip) {
+  FILE* f = fopen(path, "wb");
+  if (!f) {
+    perror(path);
+    return;
+  }
+  fprintf(f, "P6\n%d %lu\n255\n", NUM_LEDS, (unsigned long)(strip.rgb.size() / (NUM_LEDS * 3)));
+  fwrite(strip.rgb.data(), 1, strip.rgb.size(), f);
+  fclose(f);
+}
+
+static void usage() {
+  fprintf(stderr, "usage: avr_bench [--trace FILE] [--frames N] [--settle N]\n"
+                  "                 [--max-miss-percent P] [--ppm FILE] [--serial] [--parallel]\n"
+                  "                 FIRMWARE.elf\n");
+}
+
+int main(int argc, char** argv) {
+  const char* tracePath = nullptr;
+  const char* ppmPath = nullptr;
+  const char* firmwarePath = nullptr;
+  unsigned long framesPerMode = 240;
+  unsigned long settle = 90;  // TRANSITION_DURATION_MS and then some
+  double maxMissPercent = 1.0;
+  double maxSeconds = 120;    // Simulated; a stuck firmware gives up here
+  bool parallel = false;
+
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+    if (!strcmp(arg, "--serial")) { echoSerial = true; continue; }
+    if (!strcmp(arg, "--parallel")) { parallel = true; continue; }
+    if (arg[0] != '-') { firmwarePath = arg; continue; }
+    if (!value) { usage(); return 2; }
+    i++;
+    if (!strcmp(arg, "--trace")) tracePath = value;
+    else if (!strcmp(arg, "--frames")) framesPerMode = strtoul(value, nullptr, 10);
+    else if (!strcmp(arg, "--settle")) settle = strtoul(value, nullptr, 10);
+    else if (!strcmp(arg, "--max-miss-percent")) maxMissPercent = atof(value);
+    else if (!strcmp(arg, "--ppm")) ppmPath = value;
+    else { usage(); return 2; }
+  }
+  if (!firmwarePath || framesPerMode == 0) {
+    usage();
+    return 2;
+  }
+  if (parallel && NUM_SEGMENTS > 3) {
+    fprintf(stderr, "--parallel decodes at most three lanes\n");
+    return 2;
+  }
+  if (parallel && ppmPath) {
+    fprintf(stderr, "--ppm reads the single data line; leave out --parallel\n");
+    return 2;
+  }
+
+  if (tracePath) {
+    if (!loadTrace(tracePath)) return 1;
+  } else {
+    builtInTrace();
+  }
+
+  elf_firmware_t firmware;
+  memset(&firmware, 0, sizeof(firmware));
+  if (elf_read_firmware(firmwarePath, &firmware) != 0) {
+    fprintf(stderr, "%s: can't read firmware\n", firmwarePath);
+    return 1;
+  }
+
+  avr_t* avr = avr_make_mcu_by_name("atmega2560");
+  if (!avr) {
+    fprintf(stderr, "simavr has no atmega2560 core\n");
+    return 1;
+  }
+  avr_init(avr);
+  avr_load_firmware(avr, &firmware);
+  avr->frequency = F_CPU;
+
+  // Serial: capture instead of simavr's own stdout printing
+  uint32_t flags = 0;
+  avr_ioctl(avr, AVR_IOCTL_UART_GET_FLAGS('0'), &flags);
+  flags &= ~AVR_UART_FLAG_STDIO;
+  avr_ioctl(avr, AVR_IOCTL_UART_SET_FLAGS('0'), &flags);
+  avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUTPUT), uartOutputHook, nullptr);
+  avr_irq_t* uartInput = avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_INPUT);
+
+  static Mpu6050 mpu;
+  mpuAttach(avr, &mpu);
+
+  // Lane n carries its segment padded to the longest one
+  static StripDecoder strips[NUM_SEGMENTS];
+  static const char* const laneNames[] = { "PA0", "PA1", "PA2" };
+  int stripCount = parallel ? NUM_SEGMENTS : 1;
+  if (parallel) {
+    for (int lane = 0; lane < NUM_SEGMENTS; lane++) {
+      stripAttach(avr, &strips[lane], laneNames[lane], 'A', lane, SegmentLayout::maxLength() * 3, false);
+    }
+  } else {
+    stripAttach(avr, &strips[0], "PG5", 'G', 5, NUM_LEDS * 3, ppmPath != nullptr);
+  }
+  const StripDecoder& strip = strips[0];
+
+  static MarkerState markers;
+  memset(&markers, 0, sizeof(markers));
+  markers.avr = avr;
+  markers.mode = -1;
+  markers.firstMode = -1;
+  markers.settle = settle;
+  markers.framesPerMode = framesPerMode;
+  avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ('L'), IOPORT_IRQ_PIN_ALL), markerHook, &markers);
+
+  avr_cycle_count_t limit = (avr_cycle_count_t)(maxSeconds * F_CPU);
+  int state = cpu_Running;
+  while (!markers.done && avr->cycle < limit) {
+    state = avr_run(avr);
+    if (state == cpu_Done || state == cpu_Crashed) break;
+    if (markers.requestSwitch) {
+      markers.requestSwitch = false;
+      avr_raise_irq(uartInput, 'm');
+    }
+  }
+  for (int i = 0; i < stripCount; i++) stripFinishFrame(&strips[i]);
+
+  if (state == cpu_Crashed) fprintf(stderr, "firmware crashed at %.1f ms\n", cyclesToMillis(avr->cycle));
+  if (markers.mode < 0) {
+    fprintf(stderr, "no profiler markers seen: build the firmware with PROFILER_MARKERS=1\n");
+    return 1;
+  }
+
+  printf("budget %lu cycles per frame (%d FPS), %.1f s simulated, %lu frames latched, %lu short\n\n",
+         (unsigned long)FRAME_BUDGET_CYCLES, TARGET_FPS, cyclesToMillis(avr->cycle) / 1000,
+         strip.frames, strip.shortFrames);
+  printf("%-6s %7s", "mode", "frames");
+  for (int i = 0; i < STAGE_COUNT; i++) printf(" %9s_avg %9s_max", stageNames[i], stageNames[i]);
+  printf(" %10s %10s %7s %6s\n", "frame_avg", "frame_max", "budget%", "over");
+
+  bool ok = markers.done;
+  if (!ok) fprintf(stderr, "stopped before every mode was measured\n");
+  for (int mode = 0; mode < MAX_MODES; mode++) {
+    const ModeBench& m = markers.modes[mode];
+    if (m.frame.count == 0) continue;
+
+    bool pass = m.overBudget * 100.0 <= maxMissPercent * m.frame.count;
+    if (!pass) ok = false;
+    printf("%-6d %7lu", mode, m.frame.count);
+    for (int i = 0; i < STAGE_COUNT; i++) {
+      printf(" %13lu %13lu", m.stages[i].average(), m.stages[i].max);
+    }
+    printf(" %10lu %10lu %6.1f%% %6lu%s\n", m.frame.average(), m.frame.max,
+           m.frame.average() * 100.0 / FRAME_BUDGET_CYCLES, m.overBudget, pass ? "" : "  FAIL");
+  }
+
+  printf("\n%-8s %7s %6s %9s %9s %6s %6s %8s %8s\n", "line", "frames", "short", "t0h_ns", "t1h_ns",
+         "gap_us", "gapmax", "wire_us", "wiremax");
+  for (int i = 0; i < stripCount; i++) printStrip(strips[i]);
+
+  if (ppmPath) writePpm(ppmPath, strip);
+  return ok ? 0 : 1;
+}
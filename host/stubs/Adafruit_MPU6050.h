@@ -0,0 +1,58 @@
+#ifndef HOST_ADAFRUIT_MPU6050_H
+#define HOST_ADAFRUIT_MPU6050_H
+
+// Adafruit_MPU6050 stand-in for the host build.
+// getEvent() returns whatever sample the host driver last published with
+// hostSetMotionSample(), in the same units the real library reports.
+
+#include <Adafruit_Sensor.h>
+#include <Wire.h>
+
+typedef enum {
+  MPU6050_RANGE_2_G = 0,
+  MPU6050_RANGE_4_G,
+  MPU6050_RANGE_8_G,
+  MPU6050_RANGE_16_G
+} mpu6050_accel_range_t;
+
+typedef enum {
+  MPU6050_RANGE_250_DEG = 0,
+  MPU6050_RANGE_500_DEG,
+  MPU6050_RANGE_1000_DEG,
+  MPU6050_RANGE_2000_DEG
+} mpu6050_gyro_range_t;
+
+typedef enum {
+  MPU6050_BAND_260_HZ = 0,
+  MPU6050_BAND_184_HZ,
+  MPU6050_BAND_94_HZ,
+  MPU6050_BAND_44_HZ,
+  MPU6050_BAND_21_HZ,
+  MPU6050_BAND_10_HZ,
+  MPU6050_BAND_5_HZ
+} mpu6050_bandwidth_t;
+
+struct HostMotionSample {
+  float accelX, accelY, accelZ;  // m/s^2
+  float gyroX, gyroY, gyroZ;     // rad/s
+  float temp;                    // C
+};
+
+void hostSetMotionSample(const HostMotionSample& sample);
+
+class Adafruit_MPU6050 {
+public:
+  bool begin(uint8_t address = 0x68, TwoWire* wire = &Wire, int32_t sensorId = 0) {
+    (void)address;
+    (void)wire;
+    (void)sensorId;
+    return true;
+  }
+  void setAccelerometerRange(mpu6050_accel_range_t range) { (void)range; }
+  void setGyroRange(mpu6050_gyro_range_t range) { (void)range; }
+  void setFilterBandwidth(mpu6050_bandwidth_t bandwidth) { (void)bandwidth; }
+
+  bool getEvent(sensors_event_t* accel, sensors_event_t* gyro, sensors_event_t* temp);
+};
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef HOST_ADAFRUIT_SENSOR_H
+#define HOST_ADAFRUIT_SENSOR_H
+
+// Adafruit Unified Sensor stand-in for the host build
+
+#include <Arduino.h>
+
+typedef struct {
+  float x;
+  float y;
+  float z;
+} sensors_vec_t;
+
+typedef struct {
+  int32_t version;
+  int32_t sensor_id;
+  int32_t type;
+  int32_t timestamp;
+  union {
+    sensors_vec_t acceleration;
+    sensors_vec_t gyro;
+    float temperature;
+  };
+} sensors_event_t;
+
+#endif
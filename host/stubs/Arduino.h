@@ -0,0 +1,111 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Minimal Arduino core stand-in for the host build.
+// Only what the sketch sources use is provided; time is simulated so
+// renders are reproducible regardless of how fast the host runs.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include <cmath>
+#include <cstdlib>
+
+using std::abs;
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+#ifndef F_CPU
+#define F_CPU 16000000UL  // The Mega's clock, for cycle-based timing
+#endif
+
+#define HIGH 0x1
+#define LOW  0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+#define memcpy_P memcpy
+#define F(str) (str)
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+
+// Simulated clock, advanced by delay() and by the host driver
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void hostSetMicros(unsigned long us);
+void hostAdvanceMicros(unsigned long us);
+
+// Deterministic replacement for the avr-libc PRNG
+long random(long howBig);
+long random(long howSmall, long howBig);
+void randomSeed(unsigned long seed);
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+inline void noInterrupts() {}
+inline void interrupts() {}
+inline int digitalPinToInterrupt(uint8_t pin) { return pin; }
+inline void attachInterrupt(uint8_t interrupt, void (*handler)(), int mode) {
+  (void)interrupt;
+  (void)handler;
+  (void)mode;
+}
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+int analogRead(uint8_t pin);
+
+class HardwareSerial {
+public:
+  void begin(unsigned long baud) { (void)baud; }
+  operator bool() const { return true; }
+  int available() { return 0; }
+  int read() { return -1; }
+  int availableForWrite() { return 63; }
+
+  size_t write(uint8_t c);
+  size_t write(const uint8_t* buffer, size_t size);
+
+  size_t print(const char* s);
+  size_t print(char c);
+  size_t print(int n);
+  size_t print(unsigned int n);
+  size_t print(long n);
+  size_t print(unsigned long n);
+  size_t print(double n, int digits = 2);
+
+  size_t println();
+  template <typename T>
+  size_t println(T value) {
+    size_t n = print(value);
+    return n + println();
+  }
+  size_t println(double value, int digits) {
+    size_t n = print(value, digits);
+    return n + println();
+  }
+
+  // Host only: route output to stderr (default) or discard it
+  static bool echo;
+};
+
+extern HardwareSerial Serial;
+
+#endif
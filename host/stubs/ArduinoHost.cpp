@@ -0,0 +1,147 @@
+#include <Arduino.h>
+#include <Wire.h>
+#include <Adafruit_MPU6050.h>
+#include <stdio.h>
+
+HardwareSerial Serial;
+TwoWire Wire;
+bool HardwareSerial::echo = true;
+
+static unsigned long hostMicros = 0;
+static uint64_t randomState = 1;
+static HostMotionSample motionSample = { 0, 0, 9.81f, 0, 0, 0, 25.0f };
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+unsigned long millis() {
+  return hostMicros / 1000;
+}
+
+unsigned long micros() {
+  return hostMicros;
+}
+
+void delay(unsigned long ms) {
+  hostMicros += ms * 1000;
+}
+
+void delayMicroseconds(unsigned int us) {
+  hostMicros += us;
+}
+
+void hostSetMicros(unsigned long us) {
+  hostMicros = us;
+}
+
+void hostAdvanceMicros(unsigned long us) {
+  hostMicros += us;
+}
+
+// 64-bit LCG (Knuth MMIX constants); top 31 bits match the range of
+// avr-libc's random() so modulo reductions behave the same way
+static long nextRandom() {
+  randomState = randomState * 6364136223846793005ULL + 1442695040888963407ULL;
+  return (long)(randomState >> 33);
+}
+
+long random(long howBig) {
+  if (howBig == 0) return 0;
+  return nextRandom() % howBig;
+}
+
+long random(long howSmall, long howBig) {
+  if (howSmall >= howBig) return howSmall;
+  return random(howBig - howSmall) + howSmall;
+}
+
+void randomSeed(unsigned long seed) {
+  if (seed != 0) {
+    randomState = seed;
+  }
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  (void)pin;
+  (void)mode;
+}
+
+int digitalRead(uint8_t pin) {
+  (void)pin;
+  return HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  (void)pin;
+  (void)value;
+}
+
+int analogRead(uint8_t pin) {
+  (void)pin;
+  return 512;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  if (echo) fputc(c, stderr);
+  return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+  if (echo) fwrite(buffer, 1, size, stderr);
+  return size;
+}
+
+size_t HardwareSerial::print(const char* s) {
+  return write((const uint8_t*)s, strlen(s));
+}
+
+size_t HardwareSerial::print(char c) {
+  return write((uint8_t)c);
+}
+
+size_t HardwareSerial::print(int n) {
+  return print((long)n);
+}
+
+size_t HardwareSerial::print(unsigned int n) {
+  return print((unsigned long)n);
+}
+
+size_t HardwareSerial::print(long n) {
+  char buf[24];
+  snprintf(buf, sizeof(buf), "%ld", n);
+  return print(buf);
+}
+
+size_t HardwareSerial::print(unsigned long n) {
+  char buf[24];
+  snprintf(buf, sizeof(buf), "%lu", n);
+  return print(buf);
+}
+
+size_t HardwareSerial::print(double n, int digits) {
+  char buf[48];
+  snprintf(buf, sizeof(buf), "%.*f", digits, n);
+  return print(buf);
+}
+
+size_t HardwareSerial::println() {
+  return print("\r\n");
+}
+
+void hostSetMotionSample(const HostMotionSample& sample) {
+  motionSample = sample;
+}
+
+bool Adafruit_MPU6050::getEvent(sensors_event_t* accel, sensors_event_t* gyro,
+                                sensors_event_t* temp) {
+  accel->acceleration.x = motionSample.accelX;
+  accel->acceleration.y = motionSample.accelY;
+  accel->acceleration.z = motionSample.accelZ;
+  gyro->gyro.x = motionSample.gyroX;
+  gyro->gyro.y = motionSample.gyroY;
+  gyro->gyro.z = motionSample.gyroZ;
+  temp->temperature = motionSample.temp;
+  return true;
+}
@@ -0,0 +1,39 @@
+#ifndef HOST_EEPROM_H
+#define HOST_EEPROM_H
+
+// In-memory EEPROM for the host build: starts erased (0xFF) every run.
+
+#include <stdint.h>
+#include <string.h>
+
+class EEPROMClass {
+public:
+  EEPROMClass() { memset(data, 0xFF, sizeof(data)); }
+
+  uint8_t read(int address) const { return data[address]; }
+  void write(int address, uint8_t value) { data[address] = value; }
+  void update(int address, uint8_t value) { data[address] = value; }
+  uint16_t length() const { return sizeof(data); }
+
+  template <typename T>
+  T& get(int address, T& value) const {
+    memcpy(&value, &data[address], sizeof(T));
+    return value;
+  }
+
+  template <typename T>
+  const T& put(int address, const T& value) {
+    memcpy(&data[address], &value, sizeof(T));
+    return value;
+  }
+
+private:
+  uint8_t data[4096];  // ATmega2560 size
+};
+
+static EEPROMClass EEPROM;
+
+// <avr/eeprom.h>: writes here complete at once
+inline bool eeprom_is_ready() { return true; }
+
+#endif
@@ -0,0 +1,143 @@
+#ifndef HOST_FASTLED_H
+#define HOST_FASTLED_H
+
+// FastLED stand-in for the host build.
+// The pixel types and 8-bit math follow FastLED's definitions; noise and
+// colour conversion are close approximations rather than bit-exact copies,
+// so host checksums are only comparable with other host runs.
+
+#include <Arduino.h>
+
+struct CRGB;
+
+struct CHSV {
+  union {
+    struct {
+      uint8_t h;
+      uint8_t s;
+      uint8_t v;
+    };
+    uint8_t raw[3];
+  };
+
+  CHSV() : h(0), s(0), v(0) {}
+  CHSV(uint8_t ih, uint8_t is, uint8_t iv) : h(ih), s(is), v(iv) {}
+};
+
+void hsv2rgb_rainbow(const CHSV& hsv, CRGB& rgb);
+CHSV rgb2hsv_approximate(const CRGB& rgb);
+
+uint8_t scale8(uint8_t i, uint8_t scale);
+uint8_t scale8_video(uint8_t i, uint8_t scale);
+uint8_t qadd8(uint8_t i, uint8_t j);
+uint8_t qsub8(uint8_t i, uint8_t j);
+uint8_t sin8(uint8_t theta);
+uint8_t cos8(uint8_t theta);
+int16_t sin16(uint16_t theta);
+uint8_t inoise8(uint16_t x, uint16_t y);
+uint8_t inoise8(uint16_t x);
+uint8_t random8();
+uint8_t random8(uint8_t lim);
+uint16_t random16();
+
+struct CRGB {
+  union {
+    struct {
+      uint8_t r;
+      uint8_t g;
+      uint8_t b;
+    };
+    uint8_t raw[3];
+  };
+
+  enum HTMLColorCode {
+    Black = 0x000000,
+    Blue = 0x0000FF,
+    Green = 0x008000,
+    Orange = 0xFFA500,
+    Purple = 0x800080,
+    Red = 0xFF0000,
+    White = 0xFFFFFF,
+    Yellow = 0xFFFF00
+  };
+
+  CRGB() : r(0), g(0), b(0) {}
+  CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+  CRGB(uint32_t colorcode)
+    : r((colorcode >> 16) & 0xFF), g((colorcode >> 8) & 0xFF), b(colorcode & 0xFF) {}
+  CRGB(HTMLColorCode colorcode) : CRGB((uint32_t)colorcode) {}
+  CRGB(const CHSV& rhs) { hsv2rgb_rainbow(rhs, *this); }
+
+  CRGB& operator=(const CHSV& rhs) {
+    hsv2rgb_rainbow(rhs, *this);
+    return *this;
+  }
+
+  uint8_t& operator[](uint8_t x) { return raw[x]; }
+  const uint8_t& operator[](uint8_t x) const { return raw[x]; }
+
+  CRGB& nscale8(uint8_t scaledown) {
+    r = scale8(r, scaledown);
+    g = scale8(g, scaledown);
+    b = scale8(b, scaledown);
+    return *this;
+  }
+
+  CRGB& nscale8_video(uint8_t scaledown) {
+    r = scale8_video(r, scaledown);
+    g = scale8_video(g, scaledown);
+    b = scale8_video(b, scaledown);
+    return *this;
+  }
+
+  CRGB& fadeToBlackBy(uint8_t fadefactor) {
+    return nscale8(255 - fadefactor);
+  }
+
+  CRGB& operator+=(const CRGB& rhs) {
+    r = qadd8(r, rhs.r);
+    g = qadd8(g, rhs.g);
+    b = qadd8(b, rhs.b);
+    return *this;
+  }
+
+  bool operator==(const CRGB& rhs) const { return r == rhs.r && g == rhs.g && b == rhs.b; }
+  bool operator!=(const CRGB& rhs) const { return !(*this == rhs); }
+};
+
+void fill_solid(CRGB* leds, int numToFill, const CRGB& color);
+void fill_gradient_RGB(CRGB* leds, uint16_t startpos, CRGB startcolor,
+                       uint16_t endpos, CRGB endcolor);
+
+// Chipset and colour-order tags used by addLeds<>()
+class WS2812B {};
+enum EOrder { RGB = 0012, GRB = 0102 };
+
+class CFastLED {
+public:
+  template <typename CHIPSET, uint8_t DATA_PIN, EOrder ORDER>
+  void addLeds(CRGB* data, int count) {
+    leds = data;
+    numLeds = count;
+  }
+
+  void setBrightness(uint8_t scale) { brightness = scale; }
+  uint8_t getBrightness() const { return brightness; }
+  void show();
+
+  // Host only: the last frame sent to the strip, with brightness applied
+  const CRGB* shownFrame() const { return shown; }
+  int shownCount() const { return numLeds; }
+  unsigned long showCount() const { return shows; }
+
+private:
+  CRGB* leds = nullptr;
+  int numLeds = 0;
+  uint8_t brightness = 255;
+  unsigned long shows = 0;
+  CRGB shown[1024];
+};
+
+extern CFastLED FastLED;
+
+#endif
@@ -0,0 +1,249 @@
+#include <FastLED.h>
+
+CFastLED FastLED;
+
+static uint16_t rand16seed = 1337;
+
+uint8_t scale8(uint8_t i, uint8_t scale) {
+  return ((uint16_t)i * (1 + (uint16_t)scale)) >> 8;
+}
+
+uint8_t scale8_video(uint8_t i, uint8_t scale) {
+  return (((uint16_t)i * scale) >> 8) + ((i && scale) ? 1 : 0);
+}
+
+uint8_t qadd8(uint8_t i, uint8_t j) {
+  unsigned int t = i + j;
+  return t > 255 ? 255 : t;
+}
+
+uint8_t qsub8(uint8_t i, uint8_t j) {
+  return i > j ? i - j : 0;
+}
+
+int16_t sin16(uint16_t theta) {
+  return (int16_t)lrint(sin(theta * (2.0 * PI / 65536.0)) * 32767.0);
+}
+
+uint8_t sin8(uint8_t theta) {
+  return (uint8_t)lrint((sin(theta * (2.0 * PI / 256.0)) + 1.0) * 127.5);
+}
+
+uint8_t cos8(uint8_t theta) {
+  return sin8(theta + 64);
+}
+
+uint8_t random8() {
+  rand16seed = (rand16seed * 2053) + 13849;
+  return (uint8_t)((rand16seed & 0xFF) + (rand16seed >> 8));
+}
+
+uint8_t random8(uint8_t lim) {
+  return ((uint16_t)random8() * lim) >> 8;
+}
+
+uint16_t random16() {
+  rand16seed = (rand16seed * 2053) + 13849;
+  return rand16seed;
+}
+
+// Ken Perlin's reference permutation, as used by FastLED's noise functions
+static const uint8_t perm[256] = {
+  151, 160, 137, 91, 90, 15, 131, 13, 201, 95, 96, 53, 194, 233, 7, 225,
+  140, 36, 103, 30, 69, 142, 8, 99, 37, 240, 21, 10, 23, 190, 6, 148,
+  247, 120, 234, 75, 0, 26, 197, 62, 94, 252, 219, 203, 117, 35, 11, 32,
+  57, 177, 33, 88, 237, 149, 56, 87, 174, 20, 125, 136, 171, 168, 68, 175,
+  74, 165, 71, 134, 139, 48, 27, 166, 77, 146, 158, 231, 83, 111, 229, 122,
+  60, 211, 133, 230, 220, 105, 92, 41, 55, 46, 245, 40, 244, 102, 143, 54,
+  65, 25, 63, 161, 1, 216, 80, 73, 209, 76, 132, 187, 208, 89, 18, 169,
+  200, 196, 135, 130, 116, 188, 159, 86, 164, 100, 109, 198, 173, 186, 3, 64,
+  52, 217, 226, 250, 124, 123, 5, 202, 38, 147, 118, 126, 255, 82, 85, 212,
+  207, 206, 59, 227, 47, 16, 58, 17, 182, 189, 28, 42, 223, 183, 170, 213,
+  119, 248, 152, 2, 44, 154, 163, 70, 221, 153, 101, 155, 167, 43, 172, 9,
+  129, 22, 39, 253, 19, 98, 108, 110, 79, 113, 224, 232, 178, 185, 112, 104,
+  218, 246, 97, 228, 251, 34, 242, 193, 238, 210, 144, 12, 191, 179, 162, 241,
+  81, 51, 145, 235, 249, 14, 239, 107, 49, 192, 214, 31, 181, 199, 106, 157,
+  184, 84, 204, 176, 115, 121, 50, 45, 127, 4, 150, 254, 138, 236, 205, 93,
+  222, 114, 67, 29, 24, 72, 243, 141, 128, 195, 78, 66, 215, 61, 156, 180
+};
+
+static double noiseFade(double t) {
+  return t * t * t * (t * (t * 6 - 15) + 10);
+}
+
+static double noiseGrad(uint8_t hash, double x, double y) {
+  switch (hash & 3) {
+    case 0: return x + y;
+    case 1: return -x + y;
+    case 2: return x - y;
+    default: return -x - y;
+  }
+}
+
+// 2D Perlin noise on 8.8 fixed-point coordinates, mapped to 0-255
+uint8_t inoise8(uint16_t x, uint16_t y) {
+  uint8_t X = x >> 8;
+  uint8_t Y = y >> 8;
+  double xf = (x & 0xFF) / 256.0;
+  double yf = (y & 0xFF) / 256.0;
+
+  uint8_t A = perm[X] + Y;
+  uint8_t B = perm[(uint8_t)(X + 1)] + Y;
+
+  double u = noiseFade(xf);
+  double v = noiseFade(yf);
+
+  double x1 = noiseGrad(perm[A], xf, yf) +
+              u * (noiseGrad(perm[B], xf - 1, yf) - noiseGrad(perm[A], xf, yf));
+  double x2 = noiseGrad(perm[(uint8_t)(A + 1)], xf, yf - 1) +
+              u * (noiseGrad(perm[(uint8_t)(B + 1)], xf - 1, yf - 1) -
+                   noiseGrad(perm[(uint8_t)(A + 1)], xf, yf - 1));
+  double n = x1 + v * (x2 - x1);  // roughly -1..1
+
+  long scaled = lrint((n + 1.0) * 127.5);
+  return constrain(scaled, 0L, 255L);
+}
+
+uint8_t inoise8(uint16_t x) {
+  return inoise8(x, 0);
+}
+
+// FastLED's "rainbow" hue mapping: eight 32-step sections with a brighter
+// yellow band than a plain spectrum conversion
+void hsv2rgb_rainbow(const CHSV& hsv, CRGB& rgb) {
+  uint8_t hue = hsv.h;
+  uint8_t sat = hsv.s;
+  uint8_t val = hsv.v;
+
+  uint8_t offset8 = (hue & 0x1F) << 3;
+  uint8_t third = scale8(offset8, 85);
+  uint8_t twothirds = scale8(offset8, 170);
+  uint8_t r, g, b;
+
+  if (!(hue & 0x80)) {
+    if (!(hue & 0x40)) {
+      if (!(hue & 0x20)) {
+        r = 255 - third; g = third; b = 0;
+      } else {
+        r = 171; g = 85 + third; b = 0;
+      }
+    } else {
+      if (!(hue & 0x20)) {
+        r = 171 - twothirds; g = 170 + third; b = 0;
+      } else {
+        r = 0; g = 255 - third; b = third;
+      }
+    }
+  } else {
+    if (!(hue & 0x40)) {
+      if (!(hue & 0x20)) {
+        r = 0; g = 171 - twothirds; b = 85 + twothirds;
+      } else {
+        r = third; g = 0; b = 255 - third;
+      }
+    } else {
+      if (!(hue & 0x20)) {
+        r = 85 + third; g = 0; b = 171 - third;
+      } else {
+        r = 170 + third; g = 0; b = 85 - third;
+      }
+    }
+  }
+
+  if (sat != 255) {
+    if (sat == 0) {
+      r = 255; g = 255; b = 255;
+    } else {
+      uint8_t desat = 255 - sat;
+      desat = scale8_video(desat, desat);
+      uint8_t satscale = 255 - desat;
+      r = (r ? scale8(r, satscale) + 1 : 0) + desat;
+      g = (g ? scale8(g, satscale) + 1 : 0) + desat;
+      b = (b ? scale8(b, satscale) + 1 : 0) + desat;
+    }
+  }
+
+  if (val != 255) {
+    val = scale8_video(val, val);
+    if (val == 0) {
+      r = 0; g = 0; b = 0;
+    } else {
+      r = r ? scale8(r, val) + 1 : 0;
+      g = g ? scale8(g, val) + 1 : 0;
+      b = b ? scale8(b, val) + 1 : 0;
+    }
+  }
+
+  rgb.r = r;
+  rgb.g = g;
+  rgb.b = b;
+}
+
+CHSV rgb2hsv_approximate(const CRGB& rgb) {
+  uint8_t maxc = rgb.r > rgb.g ? (rgb.r > rgb.b ? rgb.r : rgb.b) : (rgb.g > rgb.b ? rgb.g : rgb.b);
+  uint8_t minc = rgb.r < rgb.g ? (rgb.r < rgb.b ? rgb.r : rgb.b) : (rgb.g < rgb.b ? rgb.g : rgb.b);
+  uint8_t delta = maxc - minc;
+
+  if (maxc == 0) return CHSV(0, 0, 0);
+  if (delta == 0) return CHSV(0, 0, maxc);
+
+  uint8_t sat = (uint16_t)delta * 255 / maxc;
+  int hue;
+  if (maxc == rgb.r) {
+    hue = 0 + 43 * ((int)rgb.g - rgb.b) / delta;
+  } else if (maxc == rgb.g) {
+    hue = 85 + 43 * ((int)rgb.b - rgb.r) / delta;
+  } else {
+    hue = 171 + 43 * ((int)rgb.r - rgb.g) / delta;
+  }
+
+  return CHSV((uint8_t)hue, sat, maxc);
+}
+
+void fill_solid(CRGB* leds, int numToFill, const CRGB& color) {
+  for (int i = 0; i < numToFill; i++) {
+    leds[i] = color;
+  }
+}
+
+void fill_gradient_RGB(CRGB* leds, uint16_t startpos, CRGB startcolor,
+                       uint16_t endpos, CRGB endcolor) {
+  if (endpos < startpos) {
+    uint16_t t = endpos;
+    endpos = startpos;
+    startpos = t;
+    CRGB c = endcolor;
+    endcolor = startcolor;
+    startcolor = c;
+  }
+
+  int32_t rdistance87 = (endcolor.r - startcolor.r) << 7;
+  int32_t gdistance87 = (endcolor.g - startcolor.g) << 7;
+  int32_t bdistance87 = (endcolor.b - startcolor.b) << 7;
+
+  uint16_t pixeldistance = endpos - startpos;
+  int16_t divisor = pixeldistance ? pixeldistance : 1;
+
+  int32_t rdelta87 = rdistance87 / divisor * 2;
+  int32_t gdelta87 = gdistance87 / divisor * 2;
+  int32_t bdelta87 = bdistance87 / divisor * 2;
+
+  int32_t r88 = startcolor.r << 8;
+  int32_t g88 = startcolor.g << 8;
+  int32_t b88 = startcolor.b << 8;
+  for (uint16_t i = startpos; i <= endpos; i++) {
+    leds[i] = CRGB(r88 >> 8, g88 >> 8, b88 >> 8);
+    r88 += rdelta87;
+    g88 += gdelta87;
+    b88 += bdelta87;
+  }
+}
+
+void CFastLED::show() {
+  int count = numLeds < 1024 ? numLeds : 1024;
+  for (int i = 0; i < count; i++) {
+    shown[i] = leds[i];
+    shown[i].nscale8_video(brightness);
+  }
+  shows++;
+}
@@ -0,0 +1,43 @@
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+// I2C stand-in for the host build. The bus is empty: every transaction
+// fails the way a missing device does on real hardware.
+
+#include <Arduino.h>
+
+#define BUFFER_LENGTH 32  // AVR Wire's transmit/receive buffer
+
+class TwoWire {
+public:
+  void begin() {}
+  void setClock(uint32_t clock) { (void)clock; }
+  void setWireTimeout(uint32_t timeout = 25000, bool resetWithTimeout = false) {
+    (void)timeout;
+    (void)resetWithTimeout;
+  }
+  bool getWireTimeoutFlag() { return false; }
+  void clearWireTimeoutFlag() {}
+
+  void beginTransmission(uint8_t address) { (void)address; }
+  uint8_t endTransmission(bool sendStop = true) {
+    (void)sendStop;
+    return 2;  // address NACK
+  }
+  uint8_t requestFrom(uint8_t address, uint8_t quantity, bool sendStop = true) {
+    (void)address;
+    (void)quantity;
+    (void)sendStop;
+    return 0;
+  }
+  size_t write(uint8_t data) {
+    (void)data;
+    return 1;
+  }
+  int available() { return 0; }
+  int read() { return -1; }
+};
+
+extern TwoWire Wire;
+
+#endif
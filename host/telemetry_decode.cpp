@@ -0,0 +1,178 @@
+/*
+ * Telemetry stream decoder
+ *
+ * Reads the binary records written with ENABLE_BINARY_TELEMETRY (see
+ * Telemetry.h) and prints one CSV line per record, prefixed with the record
+ * type. Bytes that don't form a valid record (text prints, a stream joined
+ * mid-record, line noise) are skipped until the next sync pair. Output is
+ * flushed per record so it can follow a live port:
+ *
+ *   stty -F /dev/ttyACM0 115200 raw && ./build/telemetry_decode /dev/ttyACM0
+ *
+ * Usage: telemetry_decode [FILE]   (stdin when no file is given)
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "Telemetry.h"
+#include "GestureDetector.h"
+
+struct DecodeStats {
+  unsigned long records;
+  unsigned long crcErrors;
+  unsigned long unknown;       // Valid frames with a type/version we don't know
+  unsigned long skippedBytes;
+};
+
+static void printHeader() {
+  printf("# motion,t_ms,pitch_deg,roll_deg,yaw_deg,yaw_rate_dps,rotation_dps,tilt,rotation,shake\n");
+  printf("# frame,t_ms,frame,render_us,show_us,mode,sent\n");
+  printf("# mode,t_ms,from,to\n");
+  printf("# status,t_ms,free_ram,dropped_records,fps,quality,frame_period_us\n");
+  printf("# power,t_ms,requested_ma,drawn_ma,limited_frames,skipped_frames\n");
+  printf("# gesture,t_ms,type,auto_cycle\n");
+  printf("# memory,t_ms,free_ram,stack_margin,stack_peak,static_bytes");
+  for (uint8_t i = 0; i < MEMORY_SUBSYSTEMS; i++) {
+    printf(",%s", MemoryMonitor::subsystemName(i));
+  }
+  printf("\n");
+}
+
+// Copy a payload into its struct only when type, version and size agree
+template <typename T>
+static bool payloadAs(const uint8_t* payload, uint8_t length, uint8_t version, uint8_t expected, T& out) {
+  if (version != expected || length != sizeof(T)) return false;
+  memcpy(&out, payload, sizeof(T));
+  return true;
+}
+
+static bool printRecord(uint8_t type, uint8_t version, const uint8_t* payload, uint8_t length) {
+  switch (type) {
+    case TELEMETRY_MOTION: {
+      TelemetryMotion r;
+      if (!payloadAs(payload, length, version, TELEMETRY_MOTION_VERSION, r)) return false;
+      printf("motion,%u,%.2f,%.2f,%.2f,%.1f,%.1f,%.3f,%.3f,%.3f\n",
+             (unsigned)r.timeMs, r.pitch / 100.0, r.roll / 100.0, r.yaw / 100.0,
+             r.yawRate / 10.0, r.rotationSpeed / 10.0,
+             r.tilt / 255.0, r.rotation / 255.0, r.shake / 255.0);
+      return true;
+    }
+    case TELEMETRY_FRAME: {
+      TelemetryFrame r;
+      if (!payloadAs(payload, length, version, TELEMETRY_FRAME_VERSION, r)) return false;
+      printf("frame,%u,%u,%u,%u,%u,%u\n", (unsigned)r.timeMs, (unsigned)r.frame,
+             r.renderMicros, r.showMicros, r.mode, r.sent);
+      return true;
+    }
+    case TELEMETRY_MODE: {
+      TelemetryMode r;
+      if (!payloadAs(payload, length, version, TELEMETRY_MODE_VERSION, r)) return false;
+      printf("mode,%u,%u,%u\n", (unsigned)r.timeMs, r.from, r.to);
+      return true;
+    }
+    case TELEMETRY_STATUS: {
+      TelemetryStatus r;
+      if (!payloadAs(payload, length, version, TELEMETRY_STATUS_VERSION, r)) return false;
+      printf("status,%u,%u,%u,%.2f,%u,%u\n", (unsigned)r.timeMs, r.freeRam, r.droppedRecords,
+             r.fps100 / 100.0, r.quality, r.framePeriodMicros);
+      return true;
+    }
+    case TELEMETRY_POWER: {
+      TelemetryPower r;
+      if (!payloadAs(payload, length, version, TELEMETRY_POWER_VERSION, r)) return false;
+      printf("power,%u,%u,%u,%u,%u\n", (unsigned)r.timeMs, r.requestedMilliamps, r.drawnMilliamps,
+             (unsigned)r.limitedFrames, (unsigned)r.skippedFrames);
+      return true;
+    }
+    case TELEMETRY_GESTURE: {
+      TelemetryGesture r;
+      if (!payloadAs(payload, length, version, TELEMETRY_GESTURE_VERSION, r)) return false;
+      printf("gesture,%u,%s,%u\n", (unsigned)r.timeMs, GestureDetector::name((GestureType)r.type), r.autoCycle);
+      return true;
+    }
+    case TELEMETRY_MEMORY: {
+      TelemetryMemory r;
+      if (!payloadAs(payload, length, version, TELEMETRY_MEMORY_VERSION, r)) return false;
+      printf("memory,%u,%u,%u,%u,%u", (unsigned)r.timeMs, r.freeRam, r.stackMargin, r.stackPeak, r.staticBytes);
+      for (uint8_t i = 0; i < MEMORY_SUBSYSTEMS; i++) {
+        printf(",%u", r.subsystemBytes[i]);
+      }
+      printf("\n");
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+int main(int argc, char** argv) {
+  FILE* in = stdin;
+  if (argc > 1) {
+    in = fopen(argv[1], "rb");
+    if (!in) {
+      perror(argv[1]);
+      return 1;
+    }
+  }
+
+  printHeader();
+  fflush(stdout);
+
+  DecodeStats stats = { 0, 0, 0, 0 };
+
+  // Sliding window over the stream: on a bad frame only the first sync
+  // byte is dropped, so a real record starting inside it is still found
+  uint8_t window[TELEMETRY_HEADER_BYTES + 255 + 1];
+  size_t filled = 0;
+  int c;
+
+  while ((c = fgetc(in)) != EOF) {
+    window[filled++] = (uint8_t)c;
+
+    while (filled > 0) {
+      if (window[0] != TELEMETRY_SYNC1 || (filled > 1 && window[1] != TELEMETRY_SYNC2)) {
+        memmove(window, window + 1, --filled);
+        stats.skippedBytes++;
+        continue;
+      }
+      if (filled < TELEMETRY_HEADER_BYTES) break;
+
+      uint8_t length = window[4];
+      size_t total = TELEMETRY_HEADER_BYTES + length + 1;
+      if (length > TELEMETRY_MAX_PAYLOAD) {
+        memmove(window, window + 1, --filled);
+        stats.skippedBytes++;
+        continue;
+      }
+      if (filled < total) break;
+
+      uint8_t crc = 0;
+      for (size_t i = 2; i < total - 1; i++) {
+        crc = telemetryCrc8(crc, window[i]);
+      }
+
+      if (crc != window[total - 1]) {
+        stats.crcErrors++;
+        memmove(window, window + 1, --filled);
+        stats.skippedBytes++;
+        continue;
+      }
+
+      if (printRecord(window[2], window[3], window + TELEMETRY_HEADER_BYTES, length)) {
+        stats.records++;
+        fflush(stdout);
+      } else {
+        stats.unknown++;
+      }
+      filled -= total;
+      memmove(window, window + total, filled);
+    }
+  }
+
+  fprintf(stderr, "%lu records, %lu unknown, %lu CRC errors, %lu bytes skipped\n",
+          stats.records, stats.unknown, stats.crcErrors, stats.skippedBytes);
+
+  if (in != stdin) fclose(in);
+  return 0;
+}
@@ -16,85 +16,101 @@
 #include "MotionProcessor.h"
 #include "LEDController.h"
 #include "Animations.h"
+#include "AnimationRegistry.h"
+#include "FrameProfiler.h"
+#include "FastRandom.h"
+#include "Telemetry.h"
+#include "Scheduler.h"
+#include "QualityGovernor.h"
+#include "MemoryMonitor.h"
 
 // Global objects
 MotionProcessor motionProcessor;
 LEDController ledController;
 Animations animations(ledController);
-
-// Animation state
-enum AnimationMode {
-  MODE_RAINBOW,
-  MODE_SPARKLE,
-  MODE_WAVE,
-  MODE_FIRE,
-  MODE_PULSE,
-  MODE_KALEIDOSCOPE,
-  MODE_COUNT  // Number of modes
-};
-
-AnimationMode currentMode = MODE_KALEIDOSCOPE;
+AnimationRegistry animationRegistry(animations);
+Scheduler scheduler;
+#if ENABLE_FRAME_PROFILER
+FrameProfiler frameProfiler;
+#endif
+#if ENABLE_BINARY_TELEMETRY
+Telemetry telemetry;
+#endif
+#if ENABLE_QUALITY_GOVERNOR
+QualityGovernor qualityGovernor;
+#endif
+
+// Animation state (indices into AnimationRegistry)
+uint8_t currentMode = AnimationRegistry::find("Kaleidoscope");
 unsigned long lastModeChange = 0;
+bool autoCycle = AUTO_CYCLE_MODES;  // A tilt hold toggles it
+
+// Mode transition (outgoing mode keeps rendering underneath)
+uint8_t previousMode = currentMode;
+bool inTransition = false;
 
-// Timing
-unsigned long lastFrame = 0;
-unsigned long lastMotionUpdate = 0;
+// Timing (periods are kept by the scheduler)
 unsigned long frameCount = 0;
+int8_t frameTaskId = -1;  // The governor stretches its period
+
+// Measured frame rate (window since the last motion printout or status record)
+unsigned long fpsWindowStart = 0;
+unsigned long fpsWindowFrames = 0;
+
+// Motion sensor state (retried from loop() while missing)
+bool sensorReady = false;
+unsigned long lastSensorAttempt = 0;
 
-// Mode switching button (optional - connect to pin 2)
+// Mode switching button (optional - connect to pin 2), debounced by time
 const int MODE_BUTTON_PIN = 2;
-bool lastButtonState = HIGH;
+bool buttonState = HIGH;        // Debounced
+bool buttonReading = HIGH;      // Raw, as of the last input task
+unsigned long buttonChangedAt = 0;
 
 void setup() {
   // Initialize serial communication
-  Serial.begin(115200);
-  while (!Serial && millis() < 3000); // Wait up to 3 seconds for Serial
+  Serial.begin(115200);  // No wait: the Mega's USB bridge is a plain UART
   Serial.println("\n=== Kaleidoscope Startup ===");
 
   // Initialize LED controller
   Serial.println("Initializing LEDs...");
   ledController.begin();
 
-  // Show startup animation
-  startupAnimation();
-
-  // Initialize motion processor
+  // Initialize motion processor; loop() retries if it is missing and
+  // calibration (if needed) runs in the background of the first frames
   Serial.println("Initializing motion sensor...");
-  if (!motionProcessor.begin()) {
-    Serial.println("ERROR: Failed to initialize MPU6050!");
-    Serial.println("Check wiring and restart.");
-    // Show error pattern
-    while (1) {
-      ledController.fill(CRGB::Red);
-      ledController.show();
-      delay(500);
-      ledController.clear();
-      ledController.show();
-      delay(500);
-    }
-  }
+  sensorReady = startMotionSensor();
 
-  // Calibrate motion sensor
-  Serial.println("Calibrating...");
-  ledController.fill(CRGB::Blue);
-  ledController.show();
-  motionProcessor.calibrate();
+#if ENABLE_FRAME_PROFILER
+  frameProfiler.begin();
+#endif
 
   // Setup mode button (optional)
   pinMode(MODE_BUTTON_PIN, INPUT_PULLUP);
 
+  // Seed both generators with analog noise + time
+  unsigned long seed = analogRead(0) + millis();
+  randomSeed(seed);
+  rngSeed(seed);
+
   // Random startup mode if enabled
   if (RANDOM_START_MODE) {
-    randomSeed(analogRead(0) + millis());  // Seed with analog noise + time
-    currentMode = (AnimationMode)random(MODE_COUNT);
+    currentMode = random(AnimationRegistry::count());
     Serial.print("Starting with random mode: ");
-    Serial.println(getModeName(currentMode));
   } else {
-    Serial.println("Starting with: Kaleidoscope");
+    Serial.print("Starting with: ");
   }
+  Serial.println(AnimationRegistry::name(currentMode));
+  animationRegistry.activate(currentMode);
+  Serial.print("Animation arena: ");
+  Serial.print(AnimationRegistry::arenaSize());
+  Serial.println(" bytes");
+#if ENABLE_MEMORY_MONITOR
+  printMemoryBudgets();
+#endif
 
   Serial.println("=== Kaleidoscope Ready! ===");
-  if (AUTO_CYCLE_MODES) {
+  if (autoCycle) {
     Serial.print("Auto-cycling modes every ");
     Serial.print(MODE_DURATION_MS / 1000);
     Serial.println(" seconds");
@@ -106,127 +122,268 @@ void setup() {
   Serial.println(" Hz");
   Serial.println();
 
-  lastFrame = millis();
-  lastMotionUpdate = millis();
+  // Sensor first so each frame sees the freshest sample
+  scheduler.add("sensor", sensorTask, 1000000UL / MPU_UPDATE_RATE, SCHEDULE_CATCH_UP);
+  frameTaskId = scheduler.add("frame", frameTask, FRAME_PERIOD_US, SCHEDULE_SKIP);
+#if ENABLE_QUALITY_GOVERNOR
+  resetQuality();
+#endif
+  scheduler.add("input", inputTask, INPUT_PERIOD_MS * 1000UL, SCHEDULE_SKIP);
+#if ENABLE_BINARY_TELEMETRY
+  scheduler.add("motion records", sendMotionRecord, TELEMETRY_MOTION_INTERVAL_MS * 1000UL, SCHEDULE_SKIP);
+  scheduler.add("status records", sendStatusRecords, TELEMETRY_STATUS_INTERVAL_MS * 1000UL, SCHEDULE_SKIP);
+#else
+  scheduler.add("status", printMotionData, STATUS_PRINT_INTERVAL_MS * 1000UL, SCHEDULE_SKIP);
+#endif
+
   lastModeChange = millis();
+  fpsWindowStart = millis();
+  scheduler.start();
 }
 
 void loop() {
-  unsigned long currentTime = millis();
+  scheduler.run();
 
-  // Update motion sensor at defined rate
-  if (currentTime - lastMotionUpdate >= (1000 / MPU_UPDATE_RATE)) {
-    motionProcessor.update();
-    lastMotionUpdate = currentTime;
+#if ENABLE_BINARY_TELEMETRY
+  // Idle time: whatever the UART can take without blocking; the rest
+  // waits for the next pass
+  telemetry.drain();
+#endif
+}
 
-    // Print motion data periodically for debugging (adjusted for higher FPS)
-    if (frameCount % (TARGET_FPS * 2) == 0) {  // Every 2 seconds
-      printMotionData();
+// Read the motion sensor (or retry finding it) at MPU_UPDATE_RATE
+void sensorTask() {
+  if (!sensorReady) {
+    if (millis() - lastSensorAttempt >= SENSOR_RETRY_MS) {
+      sensorReady = startMotionSensor();
     }
+    return;
   }
 
-  // Check for mode button press (if connected)
-  checkModeButton();
+  PROFILE_STAGE_BEGIN(STAGE_SENSOR);
+  motionProcessor.update();
+  PROFILE_STAGE_END(STAGE_SENSOR);
+}
 
-  // Auto-cycle modes if enabled
-  if (AUTO_CYCLE_MODES && (currentTime - lastModeChange >= MODE_DURATION_MS)) {
-    nextMode();
+// Render and show one frame
+void frameTask() {
+  unsigned long currentTime = millis();
+  PROFILE_FRAME_BEGIN(currentMode);
+  unsigned long frameStart = micros();
+
+  // Motion as it will be when this frame reaches the LEDs
+  MotionData motion = motionProcessor.getMotionDataAt(
+      motionProcessor.predictDisplayMicros(frameStart));
+
+  // Run current animation
+  PROFILE_STAGE_BEGIN(STAGE_RENDER);
+  unsigned long incomingMicros = 0;
+  if (sensorReady) {
+    incomingMicros = renderFrame(motion, currentTime);
+  } else {
+    // Error pattern: blink red once a second
+    ledController.fill((currentTime / 500) % 2 ? CRGB::Black : CRGB::Red);
+  }
+  PROFILE_STAGE_END(STAGE_RENDER);
+  unsigned long renderEnd = micros();
+
+  // Update LED strip; an unchanged frame isn't sent, which leaves the
+  // rest of the frame period to the sensor
+  PROFILE_STAGE_BEGIN(STAGE_SHOW);
+  bool shown = ledController.show();
+  PROFILE_STAGE_END(STAGE_SHOW);
+  unsigned long showMicros = micros() - renderEnd;
+  if (shown) {
+    motionProcessor.recordFrameDisplayed(frameStart, micros() + ledController.photonDelayMicros());
   }
 
-  // Frame rate control
-  if (currentTime - lastFrame >= FRAME_DELAY) {
-    // Get motion data
-    MotionData motion = motionProcessor.getMotionData();
+  PROFILE_FRAME_END();
+
+#if ENABLE_QUALITY_GOVERNOR
+  // Over budget: coarser rendering, then a slower frame rate; both come
+  // back once there is headroom again. A transition frame (two modes plus
+  // the blend, ~2x) counts only the incoming mode's render, which is what
+  // the frames after it will cost
+  unsigned long governedMicros = incomingMicros ? incomingMicros : renderEnd - frameStart;
+  if (qualityGovernor.update(governedMicros, showMicros, shown)) {
+    animations.setQuality(qualityGovernor.tier());
+    scheduler.setPeriod(frameTaskId, qualityGovernor.framePeriodMicros());
+  }
+#else
+  (void)incomingMicros;
+#endif
+
+#if ENABLE_BINARY_TELEMETRY
+  sendFrameRecord(currentTime, renderEnd - frameStart, showMicros, shown);
+#else
+  (void)showMicros;
+#endif
 
-    // Run current animation
-    runCurrentAnimation(motion, currentTime);
+  frameCount++;
+}
 
-    // Update LED strip
-    ledController.show();
+// Button, serial commands and auto-cycling; nothing here waits
+void inputTask() {
+  checkModeButton();
+  checkSerialCommands();
+#if ENABLE_GESTURES
+  checkGestures();
+#endif
 
-    lastFrame = currentTime;
-    frameCount++;
+  if (autoCycle && (millis() - lastModeChange >= MODE_DURATION_MS)) {
+    nextMode();
   }
 }
 
-void runCurrentAnimation(const MotionData& motion, unsigned long time) {
-  switch (currentMode) {
-    case MODE_RAINBOW:
-      animations.motionRainbow(motion, time);
-      break;
+// Bring the sensor up and use stored offsets when they are still valid,
+// otherwise start a background calibration. False if the MPU6050 is missing.
+bool startMotionSensor() {
+  lastSensorAttempt = millis();
+  if (!motionProcessor.begin()) {
+    Serial.println("ERROR: Failed to initialize MPU6050!");
+    Serial.println("Check wiring; retrying...");
+    return false;
+  }
 
-    case MODE_SPARKLE:
-      animations.motionSparkle(motion);
-      break;
+  if (!motionProcessor.loadCalibration()) {
+    motionProcessor.startCalibration();
+  }
+  return true;
+}
 
-    case MODE_WAVE:
-      animations.motionWave(motion, time);
-      break;
+// Current mode, blended over the previous one while a transition runs.
+// Returns the current mode's own render time on a transition frame, 0
+// on a normal one (where it is the whole render stage)
+unsigned long renderFrame(const MotionData& motion, unsigned long time) {
+  unsigned long elapsed = time - lastModeChange;
+  if (inTransition && elapsed < TRANSITION_DURATION_MS) {
+    animations.beginLayer();
+    animationRegistry.render(previousMode, motion, time);
+    animations.endLayer();
+    unsigned long incomingStart = micros();
+    animationRegistry.render(currentMode, motion, time);
+    unsigned long incomingMicros = micros() - incomingStart;
+    animations.composite(TRANSITION_STYLE, elapsed * 255 / TRANSITION_DURATION_MS);
+    return incomingMicros > 0 ? incomingMicros : 1;
+  }
 
-    case MODE_FIRE:
-      animations.motionFire(motion);
-      break;
+  inTransition = false;
+  animationRegistry.render(currentMode, motion, time);
+  return 0;
+}
 
-    case MODE_PULSE:
-      animations.motionPulse(motion, time);
-      break;
+// The reading has to hold for BUTTON_DEBOUNCE_MS before it counts
+void checkModeButton() {
+  unsigned long now = millis();
+  bool reading = digitalRead(MODE_BUTTON_PIN);
 
-    case MODE_KALEIDOSCOPE:
-      animations.motionKaleidoscope(motion, time);
-      break;
+  if (reading != buttonReading) {
+    buttonReading = reading;
+    buttonChangedAt = now;
+  } else if (reading != buttonState && now - buttonChangedAt >= BUTTON_DEBOUNCE_MS) {
+    buttonState = reading;
 
-    default:
-      animations.motionKaleidoscope(motion, time);
-      break;
+    // Button pressed (LOW because of pull-up)
+    if (buttonState == LOW) {
+      nextMode();
+    }
   }
 }
 
-void checkModeButton() {
-  bool buttonState = digitalRead(MODE_BUTTON_PIN);
-
-  // Button pressed (LOW because of pull-up)
-  if (buttonState == LOW && lastButtonState == HIGH) {
-    delay(50); // Debounce
-    if (digitalRead(MODE_BUTTON_PIN) == LOW) {
+#if ENABLE_GESTURES
+// A double tap on the tube switches mode like the button; holding it
+// tilted pauses or resumes auto-cycling. Animations see the same events
+// through MotionData.
+void checkGestures() {
+  GestureEvent event;
+  while (motionProcessor.pollGesture(event)) {
+    if (event.type == GESTURE_DOUBLE_TAP) {
       nextMode();
+    } else if (event.type == GESTURE_TILT_HOLD) {
+      autoCycle = !autoCycle;
+      lastModeChange = millis();
+    }
+
+#if ENABLE_BINARY_TELEMETRY
+    TelemetryGesture record;
+    record.timeMs = event.millis;
+    record.type = event.type;
+    record.autoCycle = autoCycle;
+    telemetry.write(TELEMETRY_GESTURE, TELEMETRY_GESTURE_VERSION, &record, sizeof(record));
+#else
+    Serial.print("Gesture: ");
+    Serial.print(GestureDetector::name(event.type));
+    if (event.type == GESTURE_TILT_HOLD) {
+      Serial.print(autoCycle ? " (auto-cycle on)" : " (auto-cycle paused)");
     }
+    Serial.println();
+#endif
   }
+}
+#endif
+
+// Serial commands: 'p' prints the frame profile, 's' the scheduler, 'l'
+// the motion-to-photon latency, 'r' resets all three, 'c' recalibrates
+// (hold the tube still and level), 'm' switches to the next mode
+void checkSerialCommands() {
+  if (!Serial.available()) return;
+
+  char command = Serial.read();
+  if (command == 'c') {
+    motionProcessor.startCalibration();
+  } else if (command == 'm') {
+    nextMode();
+  } else if (command == 'l') {
+    motionProcessor.printLatencyReport();
+  } else if (command == 's') {
+    scheduler.printReport();
+  } else if (command == 'r') {
+    motionProcessor.resetLatencyStats();
+    scheduler.reset();
+#if ENABLE_FRAME_PROFILER
+    frameProfiler.reset();
+    Serial.println("Frame profile reset");
+#endif
+  }
+#if ENABLE_FRAME_PROFILER
+  else if (command == 'p') {
+    frameProfiler.printReport(AnimationRegistry::name, AnimationRegistry::count());
+  }
+#endif
+}
 
-  lastButtonState = buttonState;
+#if ENABLE_QUALITY_GOVERNOR
+// A new mode starts at full quality and the nominal frame rate; the
+// governor only steps tiers if the mode renders them
+void resetQuality() {
+  qualityGovernor.reset(AnimationRegistry::hasQualityTiers(currentMode));
+  animations.setQuality(qualityGovernor.tier());
+  scheduler.setPeriod(frameTaskId, qualityGovernor.framePeriodMicros());
 }
+#endif
 
 void nextMode() {
-  currentMode = (AnimationMode)((currentMode + 1) % MODE_COUNT);
+  previousMode = currentMode;
+  currentMode = (currentMode + 1) % AnimationRegistry::count();
+  animationRegistry.activate(currentMode);
   lastModeChange = millis();
-
-  // Clear LEDs on mode change
-  ledController.clear();
-  ledController.show();
-
+  inTransition = true;
+  animations.startTransition();
+#if ENABLE_QUALITY_GOVERNOR
+  resetQuality();
+#endif
+
+#if ENABLE_BINARY_TELEMETRY
+  TelemetryMode record;
+  record.timeMs = lastModeChange;
+  record.from = previousMode;
+  record.to = currentMode;
+  telemetry.write(TELEMETRY_MODE, TELEMETRY_MODE_VERSION, &record, sizeof(record));
+#else
   // Print mode name
   Serial.print("Mode changed to: ");
-  Serial.println(getModeName(currentMode));
-
-  // Brief flash to indicate mode change
-  ledController.fill(CRGB::White);
-  ledController.setBrightness(100);
-  ledController.show();
-  delay(100);
-  ledController.clear();
-  ledController.show();
-  ledController.setBrightness(DEFAULT_BRIGHTNESS);
-}
-
-const char* getModeName(AnimationMode mode) {
-  switch (mode) {
-    case MODE_RAINBOW: return "Rainbow";
-    case MODE_SPARKLE: return "Sparkle";
-    case MODE_WAVE: return "Wave";
-    case MODE_FIRE: return "Fire";
-    case MODE_PULSE: return "Pulse";
-    case MODE_KALEIDOSCOPE: return "Kaleidoscope";
-    default: return "Unknown";
-  }
+  Serial.println(AnimationRegistry::name(currentMode));
+#endif
 }
 
 void printMotionData() {
@@ -255,25 +412,150 @@ void printMotionData() {
   Serial.print(motion.pitch);
   Serial.print("° Roll: ");
   Serial.print(motion.roll);
-  Serial.println("°");
-
-  Serial.print("FPS: ");
-  Serial.println(1000.0 / FRAME_DELAY);
+  Serial.print("° Yaw: ");
+  Serial.print(motion.yaw);
+  Serial.print("° (");
+  Serial.print(motion.yawRate);
+  Serial.println("°/s)");
+
+#if ENABLE_POWER_LIMIT
+  Serial.print("Power: ");
+  Serial.print(ledController.getDrawnMilliamps());
+  Serial.print("mA of ");
+  Serial.print(ledController.getRequestedMilliamps());
+  Serial.print("mA requested, headroom ");
+  Serial.print(ledController.getPowerHeadroomMilliamps());
+  Serial.print("mA, limited frames ");
+  Serial.println(ledController.getLimitedFrames());
+#endif
+#if LED_SKIP_UNCHANGED_FRAMES
+  Serial.print("Unchanged frames skipped: ");
+  Serial.println(ledController.getSkippedFrames());
+#endif
+#if ENABLE_QUALITY_GOVERNOR
+  Serial.print("Quality: ");
+  Serial.print(QualityGovernor::tierName(qualityGovernor.tier()));
+  Serial.print(", frame period ");
+  Serial.print(qualityGovernor.framePeriodMicros());
+  Serial.print("us, render ");
+  Serial.print(qualityGovernor.averageRenderMicros());
+  Serial.print("us + show ");
+  Serial.print(qualityGovernor.averageShowMicros());
+  Serial.println("us");
+#endif
+#if ENABLE_MEMORY_MONITOR
+  uint16_t stackMargin = MemoryMonitor::stackMargin();
+  Serial.print("Memory: ");
+  Serial.print(MemoryMonitor::freeRam());
+  Serial.print(" bytes free, stack peak ");
+  Serial.print(MemoryMonitor::stackPeak());
+  Serial.print(", margin ");
+  Serial.print(stackMargin);
+  Serial.println(stackMargin < MEMORY_STACK_WARN_BYTES ? " (LOW)" : "");
+#endif
+
+  // Measured rate over the frames rendered since the last printout
+  unsigned long now = millis();
+  unsigned long elapsed = now - fpsWindowStart;
+  if (elapsed > 0) {
+    Serial.print("FPS: ");
+    Serial.println((frameCount - fpsWindowFrames) * 1000.0 / elapsed);
+  }
+  fpsWindowStart = now;
+  fpsWindowFrames = frameCount;
   Serial.println();
 }
 
-void startupAnimation() {
-  // Quick rainbow sweep on startup
-  for (int i = 0; i < 256; i += 4) {
-    for (uint16_t j = 0; j < ledController.numLeds(); j++) {
-      uint8_t hue = (j * 256 / ledController.numLeds() + i) % 256;
-      ledController.setPixel(j, CHSV(hue, 255, 255));
-    }
-    ledController.show();
-    delay(5);
+#if ENABLE_MEMORY_MONITOR
+// Static footprint per subsystem against its compile-time budget
+void printMemoryBudgets() {
+  Serial.print("Static RAM: ");
+  Serial.print(MemoryMonitor::staticBytes());
+  Serial.println(" bytes");
+  for (uint8_t i = 0; i < MEMORY_SUBSYSTEMS; i++) {
+    Serial.print("  ");
+    Serial.print(MemoryMonitor::subsystemName(i));
+    Serial.print(": ");
+    Serial.print(MemoryMonitor::subsystemBytes(i));
+    Serial.print(" of ");
+    Serial.println(MemoryMonitor::subsystemBudget(i));
   }
+}
+#endif
 
-  ledController.clear();
-  ledController.show();
-  delay(500);
+#if ENABLE_BINARY_TELEMETRY
+void sendMotionRecord() {
+  unsigned long time = millis();
+  MotionData motion = motionProcessor.getMotionData();
+
+  TelemetryMotion record;
+  record.timeMs = time;
+  record.pitch = motion.pitch * 100;
+  record.roll = motion.roll * 100;
+  record.yaw = motion.yaw * 100;
+  record.yawRate = constrain(motion.yawRate * 10, -32767, 32767);
+  record.rotationSpeed = constrain(motion.rotationSpeed * 10, -32767, 32767);
+  record.tilt = motion.tiltNormalized * 255;
+  record.rotation = motion.rotationNormalized * 255;
+  record.shake = motion.shakeNormalized * 255;
+  telemetry.write(TELEMETRY_MOTION, TELEMETRY_MOTION_VERSION, &record, sizeof(record));
+}
+
+void sendFrameRecord(unsigned long time, unsigned long renderMicros, unsigned long showMicros, bool sent) {
+  TelemetryFrame record;
+  record.timeMs = time;
+  record.frame = frameCount;
+  record.renderMicros = renderMicros > 65535 ? 65535 : renderMicros;
+  record.showMicros = showMicros > 65535 ? 65535 : showMicros;
+  record.mode = currentMode;
+  record.sent = sent;
+  telemetry.write(TELEMETRY_FRAME, TELEMETRY_FRAME_VERSION, &record, sizeof(record));
+}
+
+void sendStatusRecords() {
+  unsigned long time = millis();
+  TelemetryStatus status;
+  status.timeMs = time;
+  status.freeRam = MemoryMonitor::freeRam();
+  status.droppedRecords = telemetry.getDroppedRecords();
+  unsigned long elapsed = time - fpsWindowStart;
+  status.fps100 = elapsed > 0 ? (frameCount - fpsWindowFrames) * 100000UL / elapsed : 0;
+  fpsWindowStart = time;
+  fpsWindowFrames = frameCount;
+#if ENABLE_QUALITY_GOVERNOR
+  status.quality = qualityGovernor.tier();
+  status.framePeriodMicros = qualityGovernor.framePeriodMicros();
+#else
+  status.quality = QUALITY_FULL;
+  status.framePeriodMicros = FRAME_PERIOD_US;
+#endif
+  telemetry.write(TELEMETRY_STATUS, TELEMETRY_STATUS_VERSION, &status, sizeof(status));
+
+#if ENABLE_POWER_LIMIT
+  TelemetryPower power;
+  power.timeMs = time;
+  power.requestedMilliamps = ledController.getRequestedMilliamps();
+  power.drawnMilliamps = ledController.getDrawnMilliamps();
+  power.limitedFrames = ledController.getLimitedFrames();
+#if LED_SKIP_UNCHANGED_FRAMES
+  power.skippedFrames = ledController.getSkippedFrames();
+#else
+  power.skippedFrames = 0;
+#endif
+  telemetry.write(TELEMETRY_POWER, TELEMETRY_POWER_VERSION, &power, sizeof(power));
+#endif
+
+#if ENABLE_MEMORY_MONITOR
+  TelemetryMemory memory;
+  memory.timeMs = time;
+  memory.freeRam = MemoryMonitor::freeRam();
+  memory.stackMargin = MemoryMonitor::stackMargin();
+  memory.stackPeak = MemoryMonitor::stackPeak();
+  memory.staticBytes = MemoryMonitor::staticBytes();
+  for (uint8_t i = 0; i < MEMORY_SUBSYSTEMS; i++) {
+    memory.subsystemBytes[i] = MemoryMonitor::subsystemBytes(i);
+  }
+  telemetry.write(TELEMETRY_MEMORY, TELEMETRY_MEMORY_VERSION, &memory, sizeof(memory));
+#endif
 }
+#endif